@@ -1,202 +1,2102 @@
 #include <iostream>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
 #include <memory>
+#include <functional>
 #include <iterator>
+#include <type_traits>
+#include <atomic>
 #include <list>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if __has_include(<sys/mman.h>)
+#include <sys/mman.h>
+#endif
+
+#if __has_include(<unistd.h>)
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#endif
+
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#endif
+
+// Opt-in instrumentation for right-sizing arenas: define STACKALLOC_STATS
+// before including this header and StackStorage records a high-watermark,
+// alignment padding, call counts and frees that escaped every reclaim path.
+// With the macro off neither the counters nor the updates exist.
+#ifdef STACKALLOC_STATS
+struct AllocatorStats {
+    size_t high_watermark = 0;
+    size_t padding_bytes = 0;
+    size_t allocations = 0;
+    size_t deallocations = 0;
+    size_t leaked_deallocations = 0;
+};
+#endif
+
+// Shared bump-arena bookkeeping: the cursor, the recycling free lists,
+// checkpoint/rewind and the optional stats.  Storage classes derive from it
+// and only add the actual memory.
+struct ArenaBase {
+    // Blocks freed out of LIFO order used to leak arena space; now they are
+    // remembered in small per-size free lists threaded through the freed
+    // memory itself.  Only the heads below add footprint.
+    static constexpr size_t class_step = sizeof(void*);
+    static constexpr size_t num_classes = 16;
+
+    size_t size;
+    void* free_lists[num_classes];
+#ifdef STACKALLOC_STATS
+    AllocatorStats stats_data;
+
+    const AllocatorStats& stats() const {
+        return stats_data;
+    }
+#endif
+
+    ArenaBase() : size(0), free_lists{} {}
+
+    // exact-size classes: only multiples of class_step up to
+    // class_step * num_classes bytes are recycled
+    static constexpr size_t class_index(size_t bytes) {
+        return bytes / class_step - 1;
+    }
+
+    static constexpr bool recyclable(size_t bytes) {
+        return bytes >= class_step && bytes % class_step == 0 &&
+               class_index(bytes) < num_classes;
+    }
+
+    void* try_reuse(size_t bytes, size_t alignment) {
+        if (!recyclable(bytes)) {
+            return nullptr;
+        }
+        void* head = free_lists[class_index(bytes)];
+        if (head == nullptr || reinterpret_cast<size_t>(head) % alignment != 0) {
+            return nullptr;
+        }
+        free_lists[class_index(bytes)] = *static_cast<void**>(head);
+        return head;
+    }
+
+    bool recycle(void* ptr, size_t bytes) {
+        if (!recyclable(bytes)) {
+            return false;
+        }
+        *static_cast<void**>(ptr) = free_lists[class_index(bytes)];
+        free_lists[class_index(bytes)] = ptr;
+        return true;
+    }
+
+    // Checkpoint/rewind: everything allocated after mark() is released by a
+    // single cursor store.  Callers must not touch such allocations again;
+    // recycled blocks are dropped wholesale since they may lie above the
+    // marker.
+    size_t mark() const {
+        return size;
+    }
+
+    void rewind(size_t marker) {
+        size = marker;
+        for (auto& head : free_lists) {
+            head = nullptr;
+        }
+    }
+
+    class ScopedRewind {
+        ArenaBase* st;
+        size_t marker;
+
+    public:
+        explicit ScopedRewind(ArenaBase& storage) : st(&storage), marker(storage.mark()) {}
+        ScopedRewind(const ScopedRewind&) = delete;
+        ScopedRewind& operator=(const ScopedRewind&) = delete;
+
+        ~ScopedRewind() {
+            st->rewind(marker);
+        }
+    };
+};
+
+template <size_t N>
+struct StackStorage : ArenaBase {
+    // max_align_t-aligned so the first allocation of any ordinary type
+    // needs no alignment fixup
+    alignas(std::max_align_t) int8_t data[N];
+
+    StackStorage() = default;
+};
+
+#if __has_include(<sys/mman.h>)
+
+// mmap-backed arena with the same interface as StackStorage, for node
+// arenas too big for the stack.  Transparent huge pages are requested
+// because pointer-chasing traversals over gigabyte arenas are TLB-bound.
+template <size_t N>
+struct HeapStorage : ArenaBase {
+    int8_t* data;
+
+    HeapStorage() {
+        void* mapping = mmap(nullptr, N, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (mapping == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+#ifdef MADV_HUGEPAGE
+        if (madvise(mapping, N, MADV_HUGEPAGE) != 0) {
+            // hugepages are best-effort; the mapping still works without them
+        }
+#endif
+        data = static_cast<int8_t*>(mapping);
+    }
+
+    HeapStorage(const HeapStorage&) = delete;
+    HeapStorage& operator=(const HeapStorage&) = delete;
+
+    ~HeapStorage() {
+        munmap(data, N);
+    }
+};
+
+#endif
+
+template <typename T, size_t N, typename Storage = StackStorage<N>>
+struct StackAllocator {
+    Storage* st;
+
+    using value_type = T;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using reference = T&;
+    using const_reference = const T&;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    // The arena reclaims every outstanding allocation wholesale on rewind
+    // or teardown, so containers may abandon nodes instead of handing them
+    // back one by one when the elements need no destructor.
+    static constexpr bool reclaims_in_bulk = true;
+
+    template <typename U>
+    // NOLINTNEXTLINE
+    struct rebind {
+        using other = StackAllocator<U, N, Storage>;
+    };
+
+    template <typename U>
+    StackAllocator(const StackAllocator<U, N, Storage>& copy) : st(copy.st) {}
+
+    StackAllocator(Storage& st) : st(&st) {}
+    StackAllocator(Storage* st) : st(st) {}
+
+    T* allocate(size_t count) const {
+        if (void* slot = st->try_reuse(count * sizeof(T), alignof(T))) {
+#ifdef STACKALLOC_STATS
+            ++st->stats_data.allocations;
+#endif
+            return static_cast<T*>(slot);
+        }
+        // alignments are powers of two, so rounding the cursor up is a mask,
+        // not a modulo plus branch; for byte-aligned types it folds away
+        size_t offset = st->size;
+        if constexpr (alignof(T) > 1) {
+            offset = (offset + alignof(T) - 1) & ~(alignof(T) - 1);
+        }
+        if (offset + count * sizeof(T) > N) {
+            throw std::bad_alloc();
+        }
+#ifdef STACKALLOC_STATS
+        st->stats_data.padding_bytes += offset - st->size;
+#endif
+        T *tmp = reinterpret_cast<T *>(st->data + offset);
+        st->size = offset + count * sizeof(T);
+#ifdef STACKALLOC_STATS
+        ++st->stats_data.allocations;
+        if (st->size > st->stats_data.high_watermark) {
+            st->stats_data.high_watermark = st->size;
+        }
+#endif
+        return tmp;
+    }
+
+    void deallocate(T* ptr, size_t count) const {
+#ifdef STACKALLOC_STATS
+        ++st->stats_data.deallocations;
+#endif
+        if (reinterpret_cast<int8_t*>(ptr + count) == st->data + st->size) {
+            st->size -= count * sizeof(T);
+        } else if (!st->recycle(ptr, count * sizeof(T))) {
+#ifdef STACKALLOC_STATS
+            ++st->stats_data.leaked_deallocations;
+#endif
+        }
+    }
+
+    template <typename U>
+    bool operator==(const StackAllocator<U, N, Storage>& other) const {
+        return st == other.st;
+    }
+
+};
+
+
+#if __has_include(<memory_resource>)
+
+// std::pmr adapter over the same bump-and-recycle logic.  With it, one
+// List<T, std::pmr::polymorphic_allocator<T>> instantiation per element type
+// serves every arena (stack, heap, hugepage) chosen at runtime, instead of
+// stamping out new node-management code for each (T, N) pair.
+class StackStorageResource : public std::pmr::memory_resource {
+    ArenaBase* arena;
+    int8_t* buffer;
+    size_t capacity;
+
+public:
+    template <size_t N>
+    explicit StackStorageResource(StackStorage<N>& storage)
+        : arena(&storage), buffer(storage.data), capacity(N) {}
+
+#if __has_include(<sys/mman.h>)
+    template <size_t N>
+    explicit StackStorageResource(HeapStorage<N>& storage)
+        : arena(&storage), buffer(storage.data), capacity(N) {}
+#endif
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        if (void* slot = arena->try_reuse(bytes, alignment)) {
+#ifdef STACKALLOC_STATS
+            ++arena->stats_data.allocations;
+#endif
+            return slot;
+        }
+        size_t offset = (arena->size + alignment - 1) & ~(alignment - 1);
+        if (offset + bytes > capacity) {
+            throw std::bad_alloc();
+        }
+#ifdef STACKALLOC_STATS
+        ++arena->stats_data.allocations;
+        arena->stats_data.padding_bytes += offset - arena->size;
+#endif
+        void* result = buffer + offset;
+        arena->size = offset + bytes;
+#ifdef STACKALLOC_STATS
+        if (arena->size > arena->stats_data.high_watermark) {
+            arena->stats_data.high_watermark = arena->size;
+        }
+#endif
+        return result;
+    }
+
+    void do_deallocate(void* ptr, size_t bytes, size_t) override {
+#ifdef STACKALLOC_STATS
+        ++arena->stats_data.deallocations;
+#endif
+        if (static_cast<int8_t*>(ptr) + bytes == buffer + arena->size) {
+            arena->size -= bytes;
+        } else if (!arena->recycle(ptr, bytes)) {
+#ifdef STACKALLOC_STATS
+            ++arena->stats_data.leaked_deallocations;
+#endif
+        }
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        const auto* same = dynamic_cast<const StackStorageResource*>(&other);
+        return same != nullptr && same->arena == arena;
+    }
+};
+
+#endif
+
+
+// Hands every thread its own bump arena, drawn from a shared reservation of
+// slabs, so 64 workers neither contend on a single cursor nor each burn a
+// stack-resident arena.  A slab returns to the reservation on thread exit
+// with its cursor intact: nodes may outlive the thread that allocated them,
+// and the next thread to grab the slab simply continues where it left off.
+template <size_t N>
+struct ThreadLocalStorage {
+    static StackStorage<N>& local() {
+        thread_local Holder holder;
+        return *holder.slab;
+    }
+
+private:
+    struct Reservation {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<StackStorage<N>>> slabs;
+        std::vector<StackStorage<N>*> idle;
+    };
+
+    static Reservation& reservation() {
+        static Reservation instance;
+        return instance;
+    }
+
+    struct Holder {
+        StackStorage<N>* slab;
+
+        Holder() {
+            Reservation& shared = reservation();
+            std::lock_guard<std::mutex> lock(shared.mutex);
+            if (!shared.idle.empty()) {
+                slab = shared.idle.back();
+                shared.idle.pop_back();
+            } else {
+                shared.slabs.push_back(std::make_unique<StackStorage<N>>());
+                slab = shared.slabs.back().get();
+            }
+        }
+
+        ~Holder() {
+            Reservation& shared = reservation();
+            std::lock_guard<std::mutex> lock(shared.mutex);
+            shared.idle.push_back(slab);
+        }
+    };
+};
+
+// Allocator over ThreadLocalStorage: every call resolves the calling
+// thread's slab, so the type is stateless and all instances are equal.
+// Cross-thread frees are recycled into the freeing thread's slab.
+template <typename T, size_t N>
+struct ThreadLocalAllocator {
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    template <typename U>
+    // NOLINTNEXTLINE
+    struct rebind {
+        using other = ThreadLocalAllocator<U, N>;
+    };
+
+    ThreadLocalAllocator() = default;
+
+    template <typename U>
+    ThreadLocalAllocator(const ThreadLocalAllocator<U, N>&) {}
+
+    T* allocate(size_t count) const {
+        return StackAllocator<T, N>(ThreadLocalStorage<N>::local()).allocate(count);
+    }
+
+    void deallocate(T* ptr, size_t count) const {
+        StackAllocator<T, N>(ThreadLocalStorage<N>::local()).deallocate(ptr, count);
+    }
+
+    template <typename U>
+    bool operator==(const ThreadLocalAllocator<U, N>&) const {
+        return true;
+    }
+
+};
+
 
 template <size_t N>
-struct StackStorage {
+struct PoolStorage {
     int8_t data[N];
     size_t size;
+    void* free_list;
+    size_t slot_size;
+
+    // NOLINTNEXTLINE
+    PoolStorage() : size(0), free_list(nullptr), slot_size(0) {}
+};
+
+// Bump allocator with an intrusive free list: single-object allocations
+// occupy fixed-size slots that deallocate() threads back through the freed
+// memory itself, so erase->insert cycles recycle hot slots in O(1) instead
+// of only reclaiming the last allocation like StackAllocator does.
+template <typename T, size_t N>
+struct PoolAllocator {
+    PoolStorage<N>* st;
+
+    using value_type = T;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using reference = T&;
+    using const_reference = const T&;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    // Like StackAllocator: the storage dies (or is reset) as a unit, so
+    // per-node frees on teardown buy nothing.
+    static constexpr bool reclaims_in_bulk = true;
+
+    template <typename U>
+    // NOLINTNEXTLINE
+    struct rebind {
+        using other = PoolAllocator<U, N>;
+    };
+
+    // a slot must fit both a T and the free-list link threaded through it
+    static constexpr size_t slot_bytes = sizeof(T) < sizeof(void*) ? sizeof(void*) : sizeof(T);
+    static constexpr size_t slot_align = alignof(T) < alignof(void*) ? alignof(void*) : alignof(T);
+
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U, N>& copy) : st(copy.st) {}
+
+    PoolAllocator(PoolStorage<N>& st) : st(&st) {}
+    PoolAllocator(PoolStorage<N>* st) : st(st) {}
+
+    T* allocate(size_t count) const {
+        if (count == 1 && st->free_list != nullptr && st->slot_size == slot_bytes) {
+            void* slot = st->free_list;
+            st->free_list = *static_cast<void**>(slot);
+            return static_cast<T*>(slot);
+        }
+        size_t bytes = count == 1 ? slot_bytes : count * sizeof(T);
+        size_t padding = st->size % slot_align;
+        if (padding > 0) {
+            padding = slot_align - padding;
+        }
+        if (st->size + bytes + padding > N) {
+            throw std::bad_alloc();
+        }
+        st->size += padding;
+        T* tmp = reinterpret_cast<T*>(st->data + st->size);
+        st->size += bytes;
+        return tmp;
+    }
+
+    void deallocate(T* ptr, size_t count) const {
+        if (count == 1) {
+            if (st->slot_size == 0) {
+                st->slot_size = slot_bytes;
+            }
+            if (st->slot_size == slot_bytes) {
+                *reinterpret_cast<void**>(ptr) = st->free_list;
+                st->free_list = ptr;
+                return;
+            }
+        }
+        // foreign slot size or array block: LIFO reclaim only
+        if (reinterpret_cast<int8_t*>(ptr) + count * sizeof(T) == st->data + st->size) {
+            st->size -= count * sizeof(T);
+        }
+    }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U, N>& other) const {
+        return st == other.st;
+    }
+
+};
+
+
+// Storage for the inline node slots of a small-buffer List; the
+// zero-capacity specialization is empty so the default List pays nothing.
+template <typename Node, size_t K>
+struct InlineNodeSlots {
+    alignas(Node) int8_t storage[K * sizeof(Node)];
+    uint64_t used = 0;
+
+    Node* slot(size_t index) {
+        return reinterpret_cast<Node*>(storage) + index;
+    }
+};
+
+template <typename Node>
+struct InlineNodeSlots<Node, 0> {};
+
+template <typename T, typename Allocator>
+class MpscQueue;
+
+
+template <typename T, typename Allocator = std::allocator<T>, size_t InlineCapacity = 0>
+class List {
+    static_assert(InlineCapacity <= 64, "the inline occupancy bitmap is one 64-bit word");
+
+public:
+    using value_type = T;
+    struct BaseNode {
+        BaseNode* prev = this;
+        BaseNode* next = this;
+    };
+
+    struct Node : BaseNode {
+        T key;
+
+        template <typename... Args>
+        constexpr Node(BaseNode* prev, BaseNode* next, Args&&... args)
+            : BaseNode{prev, next}, key(std::forward<Args>(args)...) {}
+    };
+
+
+private:
+    // drain_to splices queue nodes straight onto the sentinel
+    template <typename U, typename A>
+    friend class MpscQueue;
+
+    using NodeAlloc = typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+    using NodeTraits = typename std::allocator_traits<NodeAlloc>;
+
+    [[ no_unique_address ]] NodeAlloc alloc;
+    BaseNode data;
+    size_t sz = 0;
+
+    // Iterators carry plain BaseNode* even when minted from a const list
+    // (constness is enforced by the Value parameter), and mutable members
+    // are unusable in constant expressions, so the const accessors shed
+    // the qualifier here instead.
+    constexpr BaseNode* sentinel() const {
+        return const_cast<BaseNode*>(&data);
+    }
+
+    // Raw pre-acquired nodes (reserve_nodes), linked through their own
+    // storage; no T lives in them until they are handed to construct.
+    Node* spare = nullptr;
+    size_t spare_count = 0;
+
+    // Cached immutable copy handed out by snapshot(); every structural
+    // mutation drops it so the next snapshot() rebuilds from live data.
+    // shared_ptr has no constexpr destructor, so the cache sits in a union
+    // member that constant evaluation never activates.
+    struct SnapshotCache {
+        union {
+            // the literal alternative keeps List a literal type; it is the
+            // active member for the whole of any constant evaluation
+            char inactive;
+            std::shared_ptr<const List> ptr;
+        };
+
+        constexpr SnapshotCache() : inactive() {
+            if (!std::is_constant_evaluated()) {
+                std::construct_at(&ptr);
+            }
+        }
+
+        SnapshotCache(const SnapshotCache&) = delete;
+        SnapshotCache& operator=(const SnapshotCache&) = delete;
+
+        constexpr ~SnapshotCache() {
+            if (!std::is_constant_evaluated()) {
+                std::destroy_at(&ptr);
+            }
+        }
+    };
+
+    mutable SnapshotCache snapshot_cache;
+
+    constexpr void note_write() {
+        if (!std::is_constant_evaluated()) {
+            snapshot_cache.ptr.reset();
+        }
+    }
+
+    // K node slots embedded in the List object itself: short lists live
+    // entirely in the object's own cache lines with zero allocator calls
+    [[ no_unique_address ]] InlineNodeSlots<Node, InlineCapacity> inline_slots;
+
+    static constexpr uint64_t inline_full =
+        (InlineCapacity == 0) ? 0 : ~uint64_t(0) >> (64 - InlineCapacity);
+
+    constexpr Node* get_node() {
+        if constexpr (InlineCapacity > 0) {
+            if (inline_slots.used != inline_full) {
+                size_t index = size_t(std::countr_one(inline_slots.used));
+                inline_slots.used |= uint64_t(1) << index;
+                return inline_slots.slot(index);
+            }
+        }
+        if (spare != nullptr) {
+            Node* node = spare;
+            spare = *reinterpret_cast<Node**>(node);
+            --spare_count;
+            return node;
+        }
+        return NodeTraits::allocate(alloc, 1);
+    }
+
+    constexpr void put_node(Node* node) {
+        if constexpr (InlineCapacity > 0) {
+            Node* base = inline_slots.slot(0);
+            if (node >= base && node < base + InlineCapacity) {
+                inline_slots.used &= ~(uint64_t(1) << size_t(node - base));
+                return;
+            }
+        }
+        NodeTraits::deallocate(alloc, node, 1);
+    }
+
+    // If `node` lives in the inline buffer, relocates it to an allocator
+    // node (preserving its position) and returns the replacement.  Inline
+    // nodes live inside this object and must never end up linked into
+    // another list, so everything that hands nodes across list boundaries
+    // (move, swap, splice, merge) funnels through here first.
+    BaseNode* ensure_heap_node(BaseNode* node) {
+        if constexpr (InlineCapacity > 0) {
+            Node* base = inline_slots.slot(0);
+            Node* old = static_cast<Node*>(node);
+            if (old >= base && old < base + InlineCapacity) {
+                Node* fresh = NodeTraits::allocate(alloc, 1);
+                if constexpr (std::is_nothrow_move_constructible_v<T>) {
+                    NodeTraits::construct(alloc, fresh, old->prev, old->next, std::move(old->key));
+                } else {
+                    try {
+                        NodeTraits::construct(alloc, fresh, old->prev, old->next, std::move(old->key));
+                    } catch (...) {
+                        NodeTraits::deallocate(alloc, fresh, 1);
+                        throw;
+                    }
+                }
+                old->prev->next = fresh;
+                old->next->prev = fresh;
+                NodeTraits::destroy(alloc, old);
+                inline_slots.used &= ~(uint64_t(1) << size_t(old - base));
+                return fresh;
+            }
+        }
+        return node;
+    }
+
+    constexpr void evict_inline() {
+        if constexpr (InlineCapacity > 0) {
+            while (inline_slots.used != 0) {
+                size_t index = size_t(std::countr_zero(inline_slots.used));
+                ensure_heap_node(inline_slots.slot(index));
+            }
+        }
+    }
+
+    constexpr void release_spare() {
+        while (spare != nullptr) {
+            Node* node = spare;
+            spare = *reinterpret_cast<Node**>(node);
+            NodeTraits::deallocate(alloc, node, 1);
+        }
+        spare_count = 0;
+    }
+
+    // Nodes pushed back-to-back out of an arena land consecutively in
+    // memory, so stretches of the list are really a strided array of keys.
+    // run_length measures the stretch of physically consecutive nodes
+    // starting at `first` (at least 1): it ends at the first link that
+    // does not point to the node right after it in memory.
+    static size_t run_length(const Node* first) {
+        size_t len = 1;
+        while (first[len - 1].next == first + len) {
+            ++len;
+        }
+        return len;
+    }
+
+    // Search kernel shared by find/count/contains: scans each run with a
+    // dense index loop the optimizer can unroll and vectorize, and only
+    // chases a pointer to hop across run boundaries.  Returns the sentinel
+    // when nothing matches.
+    BaseNode* find_node(const T& value) const {
+        BaseNode* it = data.next;
+        while (it != &data) {
+            Node* run = static_cast<Node*>(it);
+            size_t len = run_length(run);
+            for (size_t i = 0; i < len; ++i) {
+                if (run[i].key == value) {
+                    return run + i;
+                }
+            }
+            it = run[len - 1].next;
+        }
+        return sentinel();
+    }
+
+#if __has_include(<unistd.h>)
+    // Loops over short writes; I/O failure surfaces as an exception like
+    // every other unrecoverable condition here.
+    static void write_all(int fd, const void* bytes, size_t count) {
+        const char* cursor = static_cast<const char*>(bytes);
+        while (count > 0) {
+            const ssize_t written = write(fd, cursor, count);
+            if (written < 0) {
+                throw std::runtime_error("serialize: write failed");
+            }
+            cursor += written;
+            count -= size_t(written);
+        }
+    }
+#endif
+
+    // Compiles to a cache hint where available and to nothing elsewhere;
+    // the traversal members call it on the node after next so the fetch
+    // overlaps the work applied to the current element.
+    static void prefetch(const void* node) {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(node);
+#else
+        (void)node;
+#endif
+    }
+
+    // Relinks [first, last) in front of pos.  Size bookkeeping is the
+    // caller's job; pos must not lie inside the moved range.
+    static void transfer(BaseNode* pos, BaseNode* first, BaseNode* last) {
+        if (first == last) {
+            return;
+        }
+        BaseNode* tail = last->prev;
+        first->prev->next = last;
+        last->prev = first->prev;
+        pos->prev->next = first;
+        first->prev = pos->prev;
+        tail->next = pos;
+        pos->prev = tail;
+    }
+
+    // Merges two sorted null-terminated forward chains (prev links are
+    // stale and rebuilt by the caller).  Ties prefer `a`, keeping sort stable.
+    template <typename Compare>
+    static BaseNode* merge_chains(BaseNode* a, BaseNode* b, Compare& comp) {
+        BaseNode head;
+        BaseNode* tail = &head;
+        while (a != nullptr && b != nullptr) {
+            if (comp(static_cast<Node*>(b)->key, static_cast<Node*>(a)->key)) {
+                tail->next = b;
+                b = b->next;
+            } else {
+                tail->next = a;
+                a = a->next;
+            }
+            tail = tail->next;
+        }
+        tail->next = (a != nullptr) ? a : b;
+        return head.next;
+    }
+
+    // Points the neighbours of the sentinel back at it after `data` has been
+    // overwritten wholesale (move, swap).
+    constexpr void adopt_links() {
+        if (sz == 0) {
+            data.prev = data.next = &data;
+        } else {
+            data.next->prev = &data;
+            data.prev->next = &data;
+        }
+    }
+
+    constexpr void take_nodes(List& other) {
+        note_write();
+        other.note_write();
+        other.evict_inline();
+        data = other.data;
+        sz = other.sz;
+        spare = other.spare;
+        spare_count = other.spare_count;
+        adopt_links();
+        other.data.prev = other.data.next = &other.data;
+        other.sz = 0;
+        other.spare = nullptr;
+        other.spare_count = 0;
+    }
+
+    // Arena allocators advertise reclaims_in_bulk: the storage takes back
+    // everything at rewind or teardown, so when the elements need no
+    // destructor either, tearing down a 10M-node list is a handful of
+    // member writes instead of 10M deallocate calls.
+    static constexpr bool bulk_reclaim =
+        requires { requires NodeTraits::allocator_type::reclaims_in_bulk; };
+
+    constexpr void destroy() {
+        if constexpr (std::is_trivially_destructible_v<T> && bulk_reclaim) {
+            if constexpr (InlineCapacity > 0) {
+                inline_slots.used = 0;
+            }
+            spare = nullptr;
+            spare_count = 0;
+            return;
+        }
+        BaseNode* it = data.next;
+        while (it != &data) {
+            BaseNode* tmp = it->next;
+            NodeTraits::destroy(alloc, static_cast<Node*>(it));
+            put_node(static_cast<Node*>(it));
+            it = tmp;
+        }
+        release_spare();
+    }
+
+
+public:
+
+    List() = default;
+
+    constexpr explicit List(const Allocator& allocator) :  alloc(allocator) {}
+
+    constexpr List(size_t count, const T& value, const Allocator& allocator = Allocator()) : alloc(allocator) {
+        try {
+            for (size_t i = 0; i < count; ++i) {
+                push_back(value);
+            }
+        } catch (...) {
+            destroy();
+            throw;
+        }
+    }
+
+    constexpr explicit List(size_t count, const Allocator& allocator = Allocator()) : alloc(allocator) {
+        try {
+            for (size_t i = 0; i < count; ++i) {
+                emplace_back();
+            }
+        } catch (...) {
+            destroy();
+            throw;
+        }
+    }
+
+    // The integral constraint keeps List(count, value) calls away from
+    // this overload, mirroring the pre-concepts iterator dispatch.
+    template <typename InputIt>
+        requires (!std::is_integral_v<InputIt>)
+    constexpr List(InputIt first, InputIt last, const Allocator& allocator = Allocator()) : alloc(allocator) {
+        try {
+            for (; first != last; ++first) {
+                push_back(*first);
+            }
+        } catch (...) {
+            destroy();
+            throw;
+        }
+    }
+
+    template <typename InputIt>
+        requires (!std::is_integral_v<InputIt>)
+    void assign(InputIt first, InputIt last) {
+        note_write();
+        iterator it = begin();
+        for (; it != end() && first != last; ++it, ++first) {
+            *it = *first;
+        }
+        for (; first != last; ++first) {
+            push_back(*first);
+        }
+        while (it != end()) {
+            it = erase(it);
+        }
+    }
+
+    void assign(size_t count, const T& value) {
+        note_write();
+        iterator it = begin();
+        for (; it != end() && count > 0; ++it, --count) {
+            *it = value;
+        }
+        for (; count > 0; --count) {
+            push_back(value);
+        }
+        while (it != end()) {
+            it = erase(it);
+        }
+    }
+
+    constexpr List(const List& copy, const Allocator& alloc) : alloc(alloc) {
+        try {
+            for (auto it = copy.begin(); it != copy.end(); ++it) {
+                push_back(*it);
+            }
+        } catch (...) {
+            destroy();
+            throw;
+        }
+    }
+
+    constexpr List(const List& copy) : List(copy, NodeTraits::select_on_container_copy_construction(copy.alloc)) {}
+
+    List& operator=(const List& copy) {
+        if (this == &copy) {
+            return *this;
+        }
+        if constexpr (std::allocator_traits<Allocator>::propagate_on_container_copy_assignment::value) {
+            if (!(alloc == copy.alloc)) {
+                // old nodes must be freed by the old allocator and new ones
+                // acquired from the incoming one, so rebuild and swap
+                List res(copy, copy.alloc);
+                evict_inline();
+                res.evict_inline();
+                std::swap(alloc, res.alloc);
+                std::swap(data, res.data);
+                std::swap(spare, res.spare);
+                std::swap(spare_count, res.spare_count);
+                std::swap(sz, res.sz);
+                adopt_links();
+                res.adopt_links();
+                note_write();
+                return *this;
+            }
+        }
+        // assign into the existing nodes, allocating only for the surplus
+        assign(copy.begin(), copy.end());
+        return *this;
+    }
+
+    constexpr List(List&& other) noexcept(InlineCapacity == 0) : alloc(std::move(other.alloc)) {
+        take_nodes(other);
+    }
+
+    List(List&& other, const Allocator& allocator) : alloc(allocator) {
+        if (alloc == other.alloc) {
+            take_nodes(other);
+        } else {
+            try {
+                for (auto it = other.begin(); it != other.end(); ++it) {
+                    emplace_back(std::move(*it));
+                }
+            } catch (...) {
+                destroy();
+                throw;
+            }
+        }
+    }
+
+    List& operator=(List&& other) noexcept(InlineCapacity == 0 &&
+                                           (NodeTraits::propagate_on_container_move_assignment::value ||
+                                            NodeTraits::is_always_equal::value)) {
+        if (this == &other) {
+            return *this;
+        }
+        if (NodeTraits::propagate_on_container_move_assignment::value || alloc == other.alloc) {
+            clear();
+            if constexpr (NodeTraits::propagate_on_container_move_assignment::value) {
+                alloc = std::move(other.alloc);
+            }
+            take_nodes(other);
+        } else {
+            clear();
+            for (auto it = other.begin(); it != other.end(); ++it) {
+                emplace_back(std::move(*it));
+            }
+            other.clear();
+        }
+        return *this;
+    }
+
+    void swap(List& other) noexcept(InlineCapacity == 0) {
+        note_write();
+        other.note_write();
+        evict_inline();
+        other.evict_inline();
+        if constexpr (NodeTraits::propagate_on_container_swap::value) {
+            std::swap(alloc, other.alloc);
+        }
+        std::swap(data, other.data);
+        std::swap(sz, other.sz);
+        std::swap(spare, other.spare);
+        std::swap(spare_count, other.spare_count);
+        adopt_links();
+        other.adopt_links();
+    }
+
+    using allocator_type = Allocator;
+
+    allocator_type get_allocator() const {
+        return alloc;
+    }
+
+    constexpr size_t size() const {
+        return sz;
+    }
+
+    template <typename Value>
+    struct BaseIterator {
+    public:
+        friend class List;
+        using value_type = Value;
+        using pointer = value_type*;
+        using reference = value_type&;
+        using difference_type = ptrdiff_t;
+        using const_reference = const value_type&;
+        using iterator_category = std::bidirectional_iterator_tag;
+
+    private:
+        BaseNode* item;
+
+    public:
+        BaseIterator() = default;
+
+        constexpr BaseIterator(BaseNode* item) : item(item) {}
+
+        constexpr operator BaseIterator<const Value>() const {
+            return BaseIterator<const Value>(item);
+        }
+
+        constexpr reference operator*() const {
+            return static_cast<Node*>(item)->key;
+        }
+
+        constexpr pointer operator->() const {
+            return &operator*();
+        }
+
+        constexpr BaseIterator& operator++() {
+            item = item->next;
+            return *this;
+        }
+
+        constexpr BaseIterator operator++(int) {
+            auto copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        constexpr BaseIterator& operator--() {
+            item = item->prev;
+            return *this;
+        }
+
+        constexpr BaseIterator operator--(int) {
+            auto copy = *this;
+            --*this;
+            return copy;
+        }
+
+        constexpr bool operator==(const BaseIterator<const T>& other) const {
+            return item == other.item;
+        }
+
+        constexpr bool operator==(const BaseIterator<T>& other) const {
+            return item == other.item;
+        }
+    };
+
+    using iterator = BaseIterator<T>;
+    using const_iterator = BaseIterator<const T>;
+    using reverse_iterator = std::reverse_iterator<BaseIterator<T>>;
+    using const_reverse_iterator = std::reverse_iterator<BaseIterator<const T>>;
+
+    constexpr iterator begin() {
+        return iterator(data.next);
+    }
+    constexpr iterator end() {
+        return iterator(&data);
+    }
+
+    constexpr const_iterator begin() const {
+        return const_iterator(data.next);
+    }
+    constexpr const_iterator end() const {
+        return const_iterator(sentinel());
+    }
+
+    constexpr const_iterator cbegin() const {
+        return const_iterator(data.next);
+    }
+    constexpr const_iterator cend() const {
+        return const_iterator(sentinel());
+    }
+
+    reverse_iterator rbegin() {
+        return reverse_iterator(end());
+    }
+    reverse_iterator rend() {
+        return reverse_iterator(begin());
+    }
+
+    const_reverse_iterator rbegin() const {
+        return const_reverse_iterator(cend());
+    }
+    const_reverse_iterator rend() const {
+        return const_reverse_iterator(begin());
+    }
+
+    const_reverse_iterator crbegin() const {
+        return const_reverse_iterator(cend());
+    }
+    const_reverse_iterator crend() const {
+        return const_reverse_iterator(cbegin());
+    }
+
+
+    constexpr void push_back(const T& value) {
+        insert(end(), value);
+    }
+
+    constexpr void push_back(T&& value) {
+        emplace(end(), std::move(value));
+    }
+
+    constexpr void pop_back() {
+        erase(--end());
+    }
+
+    constexpr void push_front(const T& value) {
+        insert(begin(), value);
+    }
+
+    constexpr void push_front(T&& value) {
+        emplace(begin(), std::move(value));
+    }
+
+    constexpr void pop_front() {
+        erase(begin());
+    }
+
+    template <typename... Args>
+    constexpr T& emplace_back(Args&&... args) {
+        return *emplace(end(), std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    constexpr T& emplace_front(Args&&... args) {
+        return *emplace(begin(), std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    constexpr iterator emplace(const_iterator iter, Args&&... args) {
+        Node* it = get_node();
+        // For nothrow-constructible elements the unwind handler is dead
+        // code that still keeps the whole insert path from inlining, so
+        // compile it out.  emplace itself stays potentially-throwing:
+        // get_node can always raise bad_alloc.
+        if constexpr (std::is_nothrow_constructible_v<T, Args...>) {
+            NodeTraits::construct(alloc, it, iter.item->prev, iter.item, std::forward<Args>(args)...);
+        } else {
+            try {
+                NodeTraits::construct(alloc, it, iter.item->prev, iter.item, std::forward<Args>(args)...);
+            } catch (...) {
+                put_node(it);
+                throw;
+            }
+        }
+
+        iter.item->prev->next = it;
+        iter.item->prev = it;
+        ++sz;
+        note_write();
+        return iterator(it);
+    }
+
+    constexpr iterator insert(const_iterator iter, const T& value) {
+        return emplace(iter, value);
+    }
+
+    constexpr iterator insert(const_iterator iter, T&& value) {
+        return emplace(iter, std::move(value));
+    }
+
+    // All splice overloads only relink prev/next pointers: no allocation,
+    // no element copies.  Both lists must use equal allocators.
+    void splice(const_iterator pos, List& other) {
+        if (other.sz == 0 || this == &other) {
+            return;
+        }
+        note_write();
+        other.note_write();
+        other.evict_inline();
+        transfer(pos.item, other.data.next, &other.data);
+        sz += other.sz;
+        other.sz = 0;
+    }
+
+    void splice(const_iterator pos, List& other, const_iterator iter) {
+        if (pos == iter || pos.item == iter.item->next) {
+            return;
+        }
+        note_write();
+        other.note_write();
+        BaseNode* node = (this != &other) ? other.ensure_heap_node(iter.item) : iter.item;
+        transfer(pos.item, node, node->next);
+        ++sz;
+        --other.sz;
+    }
+
+    void splice(const_iterator pos, List& other, const_iterator first, const_iterator last) {
+        if (first == last) {
+            return;
+        }
+        note_write();
+        other.note_write();
+        if (this != &other) {
+            size_t count = 0;
+            BaseNode* head = first.item;
+            for (BaseNode* it = head; it != last.item; it = it->next) {
+                it = other.ensure_heap_node(it);
+                if (count == 0) {
+                    head = it;
+                }
+                ++count;
+            }
+            sz += count;
+            other.sz -= count;
+            transfer(pos.item, head, last.item);
+        } else {
+            transfer(pos.item, first.item, last.item);
+        }
+    }
+
+    constexpr iterator erase(const_iterator iter) {
+        BaseNode* it = iter.item->next;
+        it->prev = iter.item->prev;
+        iter.item->prev->next = it;
+
+        NodeTraits::destroy(alloc, static_cast<Node*>(iter.item));
+        put_node(static_cast<Node*>(iter.item));
+        --sz;
+        note_write();
+        return it;
+    }
+
+    void resize(size_t count) {
+        while (sz > count) {
+            pop_back();
+        }
+        while (sz < count) {
+            emplace_back();
+        }
+    }
+
+    void resize(size_t count, const T& value) {
+        while (sz > count) {
+            pop_back();
+        }
+        while (sz < count) {
+            push_back(value);
+        }
+    }
+
+    // Pre-acquires node memory so that later insert/emplace calls on the
+    // hot path never reach the allocator.  Spare nodes hold no T and are
+    // returned to the allocator on destroy().
+    void reserve_nodes(size_t count) {
+        while (spare_count < count) {
+            Node* node = NodeTraits::allocate(alloc, 1);
+            *reinterpret_cast<Node**>(node) = spare;
+            spare = node;
+            ++spare_count;
+        }
+    }
+
+    void sort() {
+        sort(std::less<T>());
+    }
+
+    // Bottom-up merge sort over the existing links: O(n log n) pointer
+    // relinks, no allocations, no element copies.  Stable.
+    template <typename Compare>
+    void sort(Compare comp) {
+        if (sz < 2) {
+            return;
+        }
+        note_write();
+        BaseNode* head = data.next;
+        data.prev->next = nullptr;
+
+        // runs[i] holds a sorted chain of 2^i nodes (or is empty)
+        BaseNode* runs[64] = {};
+        size_t filled = 0;
+        while (head != nullptr) {
+            BaseNode* chain = head;
+            head = head->next;
+            chain->next = nullptr;
+            size_t i = 0;
+            for (; i < filled && runs[i] != nullptr; ++i) {
+                chain = merge_chains(runs[i], chain, comp);
+                runs[i] = nullptr;
+            }
+            if (i == filled) {
+                ++filled;
+            }
+            runs[i] = chain;
+        }
+        BaseNode* result = nullptr;
+        for (size_t i = 0; i < filled; ++i) {
+            if (runs[i] != nullptr) {
+                result = (result != nullptr) ? merge_chains(runs[i], result, comp) : runs[i];
+            }
+        }
+
+        // single pass to rebuild prev links and close the ring
+        BaseNode* prev = &data;
+        for (BaseNode* it = result; it != nullptr; it = it->next) {
+            it->prev = prev;
+            prev->next = it;
+            prev = it;
+        }
+        prev->next = &data;
+        data.prev = prev;
+    }
+
+    void reverse() {
+        note_write();
+        BaseNode* it = &data;
+        do {
+            std::swap(it->prev, it->next);
+            it = it->prev;
+        } while (it != &data);
+    }
+
+    void merge(List& other) {
+        merge(other, std::less<T>());
+    }
+
+    // Merges the sorted `other` into this sorted list by relinking nodes,
+    // like splice: no allocation, no element copies.  Stable.
+    template <typename Compare>
+    void merge(List& other, Compare comp) {
+        if (this == &other || other.sz == 0) {
+            return;
+        }
+        note_write();
+        other.note_write();
+        other.evict_inline();
+        BaseNode* first1 = data.next;
+        BaseNode* first2 = other.data.next;
+        while (first1 != &data && first2 != &other.data) {
+            if (comp(static_cast<Node*>(first2)->key, static_cast<Node*>(first1)->key)) {
+                BaseNode* next = first2->next;
+                transfer(first1, first2, next);
+                first2 = next;
+            } else {
+                first1 = first1->next;
+            }
+        }
+        if (first2 != &other.data) {
+            transfer(&data, first2, &other.data);
+        }
+        sz += other.sz;
+        other.sz = 0;
+    }
+
+    size_t unique() {
+        return unique(std::equal_to<T>());
+    }
+
+    template <typename BinaryPredicate>
+    size_t unique(BinaryPredicate pred) {
+        size_t removed = 0;
+        BaseNode* it = data.next;
+        while (it != &data && it->next != &data) {
+            if (pred(static_cast<Node*>(it)->key, static_cast<Node*>(it->next)->key)) {
+                erase(const_iterator(it->next));
+                ++removed;
+            } else {
+                it = it->next;
+            }
+        }
+        return removed;
+    }
+
+    template <typename Predicate>
+    size_t remove_if(Predicate pred) {
+        size_t removed = 0;
+        BaseNode* it = data.next;
+        while (it != &data) {
+            BaseNode* next = it->next;
+            if (pred(static_cast<Node*>(it)->key)) {
+                erase(const_iterator(it));
+                ++removed;
+            }
+            it = next;
+        }
+        return removed;
+    }
+
+    // Plain iteration serializes on every next load: the CPU cannot start
+    // fetching a node until its predecessor arrived.  These traversals walk
+    // one node ahead and prefetch next->next, overlapping that latency with
+    // the work on the current element.
+    template <typename Function>
+    void for_each(Function f) {
+        for (BaseNode* it = data.next; it != &data;) {
+            BaseNode* next = it->next;
+            prefetch(next->next);
+            f(static_cast<Node*>(it)->key);
+            it = next;
+        }
+    }
+
+    template <typename Function>
+    void for_each(Function f) const {
+        for (BaseNode* it = data.next; it != &data;) {
+            BaseNode* next = it->next;
+            prefetch(next->next);
+            f(static_cast<const Node*>(it)->key);
+            it = next;
+        }
+    }
+
+    // Applies f to the first count elements (or all of them, whichever is
+    // fewer) and, like std::for_each_n, returns the iterator past the last
+    // element visited.
+    template <typename Function>
+    iterator for_each_n(size_t count, Function f) {
+        BaseNode* it = data.next;
+        for (; count != 0 && it != &data; --count) {
+            BaseNode* next = it->next;
+            prefetch(next->next);
+            f(static_cast<Node*>(it)->key);
+            it = next;
+        }
+        return iterator(it);
+    }
+
+    template <typename Function>
+    const_iterator for_each_n(size_t count, Function f) const {
+        BaseNode* it = data.next;
+        for (; count != 0 && it != &data; --count) {
+            BaseNode* next = it->next;
+            prefetch(next->next);
+            f(static_cast<const Node*>(it)->key);
+            it = next;
+        }
+        return const_iterator(it);
+    }
+
+    // Applies f to every element concurrently: the list is cut into
+    // num_threads contiguous segments, one worker thread per segment.  The
+    // split points come from a single pointer walk up front — against the
+    // per-element work that justifies spawning threads at all, that walk is
+    // noise, and it keeps insert/erase free of segment bookkeeping.  f runs
+    // concurrently on distinct elements and must not touch list structure.
+    template <typename Function>
+    void parallel_for_each(size_t num_threads, Function f) {
+        if (num_threads <= 1 || sz < 2) {
+            for_each(std::move(f));
+            return;
+        }
+        if (num_threads > sz) {
+            num_threads = sz;
+        }
+        std::vector<BaseNode*> bounds;
+        bounds.reserve(num_threads + 1);
+        BaseNode* it = data.next;
+        bounds.push_back(it);
+        const size_t base = sz / num_threads;
+        const size_t extra = sz % num_threads;
+        for (size_t seg = 0; seg + 1 < num_threads; ++seg) {
+            const size_t len = base + (seg < extra ? 1 : 0);
+            for (size_t i = 0; i < len; ++i) {
+                it = it->next;
+            }
+            bounds.push_back(it);
+        }
+        bounds.push_back(&data);
+        std::vector<std::thread> workers;
+        workers.reserve(num_threads);
+        for (size_t seg = 0; seg < num_threads; ++seg) {
+            workers.emplace_back([first = bounds[seg], last = bounds[seg + 1], &f] {
+                for (BaseNode* node = first; node != last;) {
+                    BaseNode* next = node->next;
+                    prefetch(next->next);
+                    f(static_cast<Node*>(node)->key);
+                    node = next;
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    template <typename Function>
+    void parallel_for_each(size_t num_threads, Function f) const {
+        const_cast<List*>(this)->parallel_for_each(num_threads,
+                [&f](T& item) { f(static_cast<const T&>(item)); });
+    }
+
+    // Linear search over runs of physically consecutive nodes (the common
+    // layout for arena-backed lists); see find_node/run_length above.
+    iterator find(const T& value) {
+        return iterator(find_node(value));
+    }
+
+    const_iterator find(const T& value) const {
+        return const_iterator(find_node(value));
+    }
+
+    bool contains(const T& value) const {
+        return find_node(value) != &data;
+    }
+
+    size_t count(const T& value) const {
+        size_t matches = 0;
+        BaseNode* it = data.next;
+        while (it != &data) {
+            Node* run = static_cast<Node*>(it);
+            size_t len = run_length(run);
+            for (size_t i = 0; i < len; ++i) {
+                matches += (run[i].key == value) ? 1 : 0;
+            }
+            it = run[len - 1].next;
+        }
+        return matches;
+    }
+
+    // For read-mostly lists (config, routing tables): workers grab an
+    // immutable refcounted view and traverse it lock-free while the writer
+    // keeps mutating the live list.  The O(n) copy is paid at most once per
+    // write burst — snapshot() calls between writes all hand out the same
+    // cached copy, and every structural mutation drops the cache.
+    // snapshot() itself needs the same external synchronization against
+    // writers as any other member; the returned view never changes.  Note
+    // that element writes through iterators bypass the invalidation — call
+    // a mutator (or assign) if snapshots must observe them.
+    std::shared_ptr<const List> snapshot() const {
+        if (snapshot_cache.ptr == nullptr) {
+            snapshot_cache.ptr = std::make_shared<const List>(*this);
+        }
+        return snapshot_cache.ptr;
+    }
+
+    // Contiguous export for scan phases: freeze() moves the elements into
+    // one array allocated through the same allocator family, turning a
+    // latency-bound pointer chase into streaming sequential reads with O(1)
+    // positional access.  thaw() moves them back when mutation resumes.
+    class Frozen {
+        friend class List;
+
+        using ValueAlloc = typename NodeTraits::template rebind_alloc<T>;
+        using ValueTraits = std::allocator_traits<ValueAlloc>;
+
+        [[ no_unique_address ]] ValueAlloc alloc;
+        T* items = nullptr;
+        size_t count = 0;
+
+        explicit Frozen(const ValueAlloc& allocator) : alloc(allocator) {}
+
+        void release() {
+            for (size_t i = 0; i < count; ++i) {
+                ValueTraits::destroy(alloc, items + i);
+            }
+            if (items != nullptr) {
+                ValueTraits::deallocate(alloc, items, count);
+            }
+            items = nullptr;
+            count = 0;
+        }
+
+    public:
+        using iterator = T*;
+        using const_iterator = const T*;
+
+        Frozen(const Frozen&) = delete;
+        Frozen& operator=(const Frozen&) = delete;
+
+        Frozen(Frozen&& other) noexcept
+                : alloc(other.alloc), items(other.items), count(other.count) {
+            other.items = nullptr;
+            other.count = 0;
+        }
+
+        size_t size() const { return count; }
+
+        T& operator[](size_t index) { return items[index]; }
+        const T& operator[](size_t index) const { return items[index]; }
+
+        iterator begin() { return items; }
+        iterator end() { return items + count; }
+        const_iterator begin() const { return items; }
+        const_iterator end() const { return items + count; }
+
+        ~Frozen() {
+            release();
+        }
+    };
+
+    // Elements are moved when that cannot throw and copied otherwise, so a
+    // throwing element constructor leaves the list intact.  The list is
+    // empty afterwards; the nodes are returned to the allocator.
+    Frozen freeze() {
+        Frozen frozen((typename Frozen::ValueAlloc(alloc)));
+        if (sz == 0) {
+            return frozen;
+        }
+        frozen.items = Frozen::ValueTraits::allocate(frozen.alloc, sz);
+        BaseNode* it = data.next;
+        try {
+            for (; frozen.count < sz; ++frozen.count, it = it->next) {
+                Frozen::ValueTraits::construct(frozen.alloc, frozen.items + frozen.count,
+                        std::move_if_noexcept(static_cast<Node*>(it)->key));
+            }
+        } catch (...) {
+            for (size_t i = 0; i < frozen.count; ++i) {
+                Frozen::ValueTraits::destroy(frozen.alloc, frozen.items + i);
+            }
+            Frozen::ValueTraits::deallocate(frozen.alloc, frozen.items, sz);
+            frozen.items = nullptr;
+            frozen.count = 0;
+            throw;
+        }
+        clear();
+        return frozen;
+    }
+
+    // Appends the frozen elements back in order and releases the array.
+    void thaw(Frozen&& frozen) {
+        for (size_t i = 0; i < frozen.count; ++i) {
+            push_back(std::move(frozen.items[i]));
+        }
+        frozen.release();
+    }
+
+#if __has_include(<unistd.h>) && __has_include(<sys/mman.h>)
+    // Binary persistence between pipeline stages: the element count
+    // followed by the raw element bytes, so it exists only for trivially
+    // copyable T.  Elements are batched through one buffer into a few
+    // large writes instead of one iostream insertion per node.
+    void serialize(int fd) const {
+        static_assert(std::is_trivially_copyable_v<T>,
+                "the binary format is the raw element bytes");
+        uint64_t count = sz;
+        write_all(fd, &count, sizeof(count));
+        std::vector<T> buffer;
+        const size_t batch = (size_t(1) << 20) / sizeof(T) + 1;
+        buffer.reserve(batch);
+        for (BaseNode* it = data.next; it != &data; it = it->next) {
+            buffer.push_back(static_cast<Node*>(it)->key);
+            if (buffer.size() == batch) {
+                write_all(fd, buffer.data(), buffer.size() * sizeof(T));
+                buffer.clear();
+            }
+        }
+        if (!buffer.empty()) {
+            write_all(fd, buffer.data(), buffer.size() * sizeof(T));
+        }
+    }
+
+    // Rebuilds a list from a serialize()d file.  The file is mapped
+    // read-only and consumed in one sequential pass, so instead of being
+    // re-parsed up front the data is paged in lazily by the kernel just
+    // ahead of the cursor.
+    static List load_mapped(const char* path, const Allocator& allocator = Allocator()) {
+        static_assert(std::is_trivially_copyable_v<T>,
+                "the binary format is the raw element bytes");
+        int fd = open(path, O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("load_mapped: cannot open file");
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0) {
+            close(fd);
+            throw std::runtime_error("load_mapped: cannot stat file");
+        }
+        const size_t bytes = size_t(info.st_size);
+        if (bytes < sizeof(uint64_t)) {
+            close(fd);
+            throw std::runtime_error("load_mapped: truncated file");
+        }
+        void* mapping = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);  // the mapping keeps the file referenced
+        if (mapping == MAP_FAILED) {
+            throw std::runtime_error("load_mapped: mmap failed");
+        }
+        List result(allocator);
+        try {
+            uint64_t count;
+            std::memcpy(&count, mapping, sizeof(count));
+            if (count > (bytes - sizeof(count)) / sizeof(T)) {
+                throw std::runtime_error("load_mapped: truncated file");
+            }
+            const int8_t* cursor = static_cast<const int8_t*>(mapping) + sizeof(count);
+            for (uint64_t i = 0; i < count; ++i) {
+                // memcpy through an aligned buffer: the mapped region only
+                // guarantees the header's alignment, not alignof(T)
+                alignas(T) int8_t raw[sizeof(T)];
+                std::memcpy(raw, cursor + i * sizeof(T), sizeof(T));
+                result.push_back(*reinterpret_cast<const T*>(raw));
+            }
+        } catch (...) {
+            munmap(mapping, bytes);
+            throw;
+        }
+        munmap(mapping, bytes);
+        return result;
+    }
+#endif
+
+    constexpr void clear() {
+        note_write();
+        destroy();
+        data.prev = data.next = &data;
+        sz = 0;
+    }
+
+    constexpr ~List() {
+        destroy();
+    }
+};
+
+
+// Arena-resident sibling of List for StackStorage arenas under 4GB: prev and
+// next are 32-bit offsets from the storage base instead of 64-bit pointers,
+// halving link overhead and shrinking every node by 8 bytes.  At a billion
+// nodes that is 8GB of link metadata saved.  Nodes are pinned to one arena,
+// so the list is movable but not copyable.
+template <typename T, size_t N>
+class CompactList {
+    static_assert(N <= (size_t(1) << 32), "links are 32-bit offsets from the arena base");
+
+    struct Link {
+        uint32_t prev;
+        uint32_t next;
+    };
+
+    struct Node {
+        Link link;
+        T key;
+    };
+
+    static_assert(std::is_standard_layout_v<Node>, "Link must be addressable at offset zero");
+
+    StackStorage<N>* st;
+    uint32_t head;
+    size_t sz = 0;
+
+    Link* at(uint32_t offset) const {
+        return reinterpret_cast<Link*>(st->data + offset);
+    }
+
+    Node* node_at(uint32_t offset) const {
+        return reinterpret_cast<Node*>(st->data + offset);
+    }
+
+    uint32_t offset_of(const void* ptr) const {
+        return static_cast<uint32_t>(static_cast<const int8_t*>(ptr) - st->data);
+    }
+
+public:
+    using value_type = T;
+
+    template <typename Value>
+    struct BaseIterator {
+    public:
+        friend class CompactList;
+        using value_type = Value;
+        using pointer = value_type*;
+        using reference = value_type&;
+        using difference_type = ptrdiff_t;
+        using iterator_category = std::bidirectional_iterator_tag;
+
+    private:
+        int8_t* base = nullptr;
+        uint32_t offset = 0;
+
+        Link* link() const {
+            return reinterpret_cast<Link*>(base + offset);
+        }
+
+    public:
+        BaseIterator() = default;
+
+        BaseIterator(int8_t* base, uint32_t offset) : base(base), offset(offset) {}
+
+        operator BaseIterator<const Value>() const {
+            return BaseIterator<const Value>(base, offset);
+        }
+
+        reference operator*() const {
+            return reinterpret_cast<Node*>(base + offset)->key;
+        }
+
+        pointer operator->() const {
+            return &operator*();
+        }
+
+        BaseIterator& operator++() {
+            offset = link()->next;
+            return *this;
+        }
+
+        BaseIterator operator++(int) {
+            auto copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        BaseIterator& operator--() {
+            offset = link()->prev;
+            return *this;
+        }
+
+        BaseIterator operator--(int) {
+            auto copy = *this;
+            --*this;
+            return copy;
+        }
+
+        bool operator==(const BaseIterator<const T>& other) const {
+            return base == other.base && offset == other.offset;
+        }
+
+        bool operator==(const BaseIterator<T>& other) const {
+            return base == other.base && offset == other.offset;
+        }
+    };
+
+    using iterator = BaseIterator<T>;
+    using const_iterator = BaseIterator<const T>;
+    using reverse_iterator = std::reverse_iterator<BaseIterator<T>>;
+    using const_reverse_iterator = std::reverse_iterator<BaseIterator<const T>>;
+
+    explicit CompactList(StackStorage<N>& storage) : st(&storage) {
+        // the sentinel is a bare Link placed in the arena, so every link in
+        // the ring is an offset and no node is special
+        Link* sentinel = StackAllocator<Link, N>(st).allocate(1);
+        head = offset_of(sentinel);
+        sentinel->prev = sentinel->next = head;
+    }
+
+    CompactList(const CompactList&) = delete;
+    CompactList& operator=(const CompactList&) = delete;
+
+    // not noexcept: the moved-from list needs a fresh sentinel to stay usable
+    CompactList(CompactList&& other) : st(other.st), head(other.head), sz(other.sz) {
+        other.sz = 0;
+        Link* sentinel = StackAllocator<Link, N>(other.st).allocate(1);
+        other.head = other.offset_of(sentinel);
+        sentinel->prev = sentinel->next = other.head;
+    }
+
+    size_t size() const {
+        return sz;
+    }
+
+    iterator begin() {
+        return iterator(st->data, at(head)->next);
+    }
+    iterator end() {
+        return iterator(st->data, head);
+    }
+
+    const_iterator begin() const {
+        return const_iterator(st->data, at(head)->next);
+    }
+    const_iterator end() const {
+        return const_iterator(st->data, head);
+    }
+
+    reverse_iterator rbegin() {
+        return reverse_iterator(end());
+    }
+    reverse_iterator rend() {
+        return reverse_iterator(begin());
+    }
 
-    // NOLINTNEXTLINE
-    StackStorage() : size(0) {}
-};
+    template <typename... Args>
+    iterator emplace(const_iterator pos, Args&&... args) {
+        Node* node = StackAllocator<Node, N>(st).allocate(1);
+        try {
+            std::construct_at(&node->key, std::forward<Args>(args)...);
+        } catch (...) {
+            StackAllocator<Node, N>(st).deallocate(node, 1);
+            throw;
+        }
+        uint32_t node_offset = offset_of(node);
+        Link* position = at(pos.offset);
+        node->link.prev = position->prev;
+        node->link.next = pos.offset;
+        at(position->prev)->next = node_offset;
+        position->prev = node_offset;
+        ++sz;
+        return iterator(st->data, node_offset);
+    }
 
-template <typename T, size_t N>
-struct StackAllocator {
-    StackStorage<N>* st;
+    iterator insert(const_iterator pos, const T& value) {
+        return emplace(pos, value);
+    }
 
-    using value_type = T;
-    using pointer = T*;
-    using const_pointer = const T*;
-    using reference = T&;
-    using const_reference = const T&;
-    using size_type = std::size_t;
-    using difference_type = std::ptrdiff_t;
+    iterator insert(const_iterator pos, T&& value) {
+        return emplace(pos, std::move(value));
+    }
 
-    template <typename U>
-    // NOLINTNEXTLINE
-    struct rebind {
-        using other = StackAllocator<U, N>;
-    };
+    void push_back(const T& value) {
+        emplace(end(), value);
+    }
 
-    template <typename U>
-    StackAllocator(const StackAllocator<U, N>& copy) : st(copy.st) {}
+    void push_front(const T& value) {
+        emplace(begin(), value);
+    }
 
-    StackAllocator(StackStorage<N>& st) : st(&st) {}
-    StackAllocator(StackStorage<N>* st) : st(st) {}
+    iterator erase(const_iterator pos) {
+        Node* node = node_at(pos.offset);
+        uint32_t next = node->link.next;
+        at(node->link.prev)->next = next;
+        at(next)->prev = node->link.prev;
+        std::destroy_at(&node->key);
+        StackAllocator<Node, N>(st).deallocate(node, 1);
+        --sz;
+        return iterator(st->data, next);
+    }
 
-    T* allocate(size_t count) const {
-        size_t padding = st->size % alignof(T);
-        if (padding > 0) {
-            padding = alignof(T) - padding;
-        }
-        if (st->size + count * sizeof(T) + padding > N) {
-            throw std::bad_alloc();
-        }
-        st->size += padding;
-        T *tmp = reinterpret_cast<T *>(st->data + st->size);
-        st->size += count * sizeof(T);
-        return tmp;
+    void pop_back() {
+        erase(--end());
     }
 
-    void deallocate(T* ptr, size_t count) const {
-        if (reinterpret_cast<int8_t*>(ptr + count) == st->data + st->size) {
-            st->size -= count * sizeof(T);
+    void pop_front() {
+        erase(begin());
+    }
+
+    void clear() {
+        while (sz > 0) {
+            pop_back();
         }
     }
 
+    ~CompactList() {
+        clear();
+        StackAllocator<Link, N>(st).deallocate(at(head), 1);
+    }
 };
 
 
-template <typename T, typename Allocator = std::allocator<T>>
-class List {
+// Unrolled sibling of List: each node packs up to B elements with an
+// occupancy bitmap, so scan-heavy traversals touch a cache line per B
+// elements instead of per element and link overhead is amortized across the
+// whole node.  Element order is slot order; erase just clears a bit, insert
+// fills a gap in the target node or splits it, so both stay O(1) amortized
+// for a fixed B.
+template <typename T, size_t B, typename Allocator = std::allocator<T>>
+class UnrolledList {
+    static_assert(B >= 2 && B <= 64, "the occupancy bitmap is one 64-bit word");
+
 public:
     using value_type = T;
+
+    // The bitmap lives in the base so the sentinel reads as an empty node
+    // and iteration needs no special end-of-list handling.
     struct BaseNode {
         BaseNode* prev = this;
         BaseNode* next = this;
+        uint64_t occupied = 0;
+
+        bool test(size_t index) const {
+            return ((occupied >> index) & 1u) != 0;
+        }
+
+        // index of the first occupied slot at or above `from`, B if none
+        size_t next_set(size_t from) const {
+            if (from >= B) {
+                return B;
+            }
+            uint64_t mask = occupied >> from;
+            return mask == 0 ? B : from + size_t(std::countr_zero(mask));
+        }
+
+        // index of the last occupied slot at or below `from`, B if none
+        size_t prev_set(size_t from) const {
+            uint64_t mask = occupied;
+            if (from < 63) {
+                mask &= (uint64_t(1) << (from + 1)) - 1;
+            }
+            return mask == 0 ? B : 63 - size_t(std::countl_zero(mask));
+        }
     };
 
     struct Node : BaseNode {
-        T key;
+        alignas(T) int8_t storage[B * sizeof(T)];
 
-        Node(BaseNode* prev, BaseNode* next, const T& key) : BaseNode{prev, next}, key(key) {}
-        Node(BaseNode* prev, BaseNode* next) : BaseNode{prev, next}, key() {}
-    };
+        Node(BaseNode* prev, BaseNode* next) : BaseNode{prev, next} {}
 
+        T* slot(size_t index) {
+            return reinterpret_cast<T*>(storage) + index;
+        }
+    };
 
 private:
     using NodeAlloc = typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
     using NodeTraits = typename std::allocator_traits<NodeAlloc>;
+    using ValueAlloc = typename std::allocator_traits<Allocator>::template rebind_alloc<T>;
+    using ValueTraits = typename std::allocator_traits<ValueAlloc>;
 
     [[ no_unique_address ]] NodeAlloc alloc;
     mutable BaseNode data;
     size_t sz = 0;
 
-    void emplace_back() {
-        Node *it = NodeTraits::allocate(alloc, 1);
+    Node* make_node(BaseNode* prev, BaseNode* next) {
+        Node* node = NodeTraits::allocate(alloc, 1);
         try {
-            NodeTraits::construct(alloc, it, data.prev, &data);
+            NodeTraits::construct(alloc, node, prev, next);
         } catch (...) {
-            NodeTraits::deallocate(alloc, it, 1);
+            NodeTraits::deallocate(alloc, node, 1);
             throw;
         }
+        prev->next = node;
+        next->prev = node;
+        return node;
+    }
+
+    void drop_node(Node* node) {
+        node->prev->next = node->next;
+        node->next->prev = node->prev;
+        NodeTraits::destroy(alloc, node);
+        NodeTraits::deallocate(alloc, node, 1);
+    }
 
-        data.prev->next = it;
-        data.prev = it;
+    template <typename... Args>
+    void construct_slot(Node* node, size_t index, Args&&... args) {
+        ValueAlloc value_alloc(alloc);
+        ValueTraits::construct(value_alloc, node->slot(index), std::forward<Args>(args)...);
+        node->occupied |= uint64_t(1) << index;
         ++sz;
     }
 
+    void destroy_slot(Node* node, size_t index) {
+        ValueAlloc value_alloc(alloc);
+        ValueTraits::destroy(value_alloc, node->slot(index));
+        node->occupied &= ~(uint64_t(1) << index);
+        --sz;
+    }
+
     void destroy() {
         BaseNode* it = data.next;
         while (it != &data) {
             BaseNode* tmp = it->next;
-            NodeTraits::destroy(alloc, static_cast<Node*>(it));
-            NodeTraits::deallocate(alloc, static_cast<Node*>(it), 1);
-            it = tmp;
-        }
-    }
-
-
-public:
-
-    List() = default;
-
-    explicit List(const Allocator& allocator) :  alloc(allocator) {}
-
-    List(size_t count, const T& value, const Allocator& allocator = Allocator()) : alloc(allocator) {
-        try {
-            for (size_t i = 0; i < count; ++i) {
-                push_back(value);
-            }
-        } catch (...) {
-            destroy();
-            throw;
-        }
-    }
-
-    explicit List(size_t count, const Allocator& allocator = Allocator()) : alloc(allocator) {
-        try {
-            for (size_t i = 0; i < count; ++i) {
-                emplace_back();
+            Node* node = static_cast<Node*>(it);
+            for (size_t i = node->next_set(0); i < B; i = node->next_set(i + 1)) {
+                ValueAlloc value_alloc(alloc);
+                ValueTraits::destroy(value_alloc, node->slot(i));
             }
-        } catch (...) {
-            destroy();
-            throw;
+            NodeTraits::destroy(alloc, node);
+            NodeTraits::deallocate(alloc, node, 1);
+            it = tmp;
         }
     }
 
-    List(const List& copy, const Allocator& alloc) : alloc(alloc) {
-        try {
-            for (auto it = copy.begin(); it != copy.end(); ++it) {
-                push_back(*it);
-            }
-        } catch (...) {
-            destroy();
-            throw;
+    void adopt_links() {
+        if (sz == 0) {
+            data.prev = data.next = &data;
+        } else {
+            data.next->prev = &data;
+            data.prev->next = &data;
         }
     }
 
-    List(const List& copy) : List(copy, NodeTraits::select_on_container_copy_construction(copy.alloc)) {}
-
-    List& operator=(const List& copy) {
-        List res(copy, std::allocator_traits<Allocator>::propagate_on_container_copy_assignment::value ?
-                       copy.alloc : alloc);
-        std::swap(alloc, res.alloc);
-        std::swap(data, res.data);
-        sz = res.sz;
-        data.next->prev = &data;
-        data.prev->next = &data;
-        res.data.prev->next = &res.data;
-        return *this;
-    }
-
-    using allocator_type = Allocator;
-
-    allocator_type get_allocator() const {
-        return alloc;
-    }
-
-    size_t size() const {
-        return sz;
-    }
-
+public:
     template <typename Value>
     struct BaseIterator {
     public:
-        friend class List;
+        friend class UnrolledList;
         using value_type = Value;
         using pointer = value_type*;
         using reference = value_type&;
         using difference_type = ptrdiff_t;
-        using const_reference = const value_type&;
         using iterator_category = std::bidirectional_iterator_tag;
 
     private:
-        BaseNode* item;
+        BaseNode* item = nullptr;
+        size_t index = 0;
+
+        Node* node() const {
+            return static_cast<Node*>(item);
+        }
 
     public:
         BaseIterator() = default;
 
-        BaseIterator(BaseNode* item) : item(item) {}
+        BaseIterator(BaseNode* item, size_t index) : item(item), index(index) {}
 
         operator BaseIterator<const Value>() const {
-            return BaseIterator<const Value>(item);
+            return BaseIterator<const Value>(item, index);
         }
 
         reference operator*() const {
-            return static_cast<Node*>(item)->key;
+            return *node()->slot(index);
         }
 
         pointer operator->() const {
@@ -204,7 +2104,15 @@ public:
         }
 
         BaseIterator& operator++() {
-            item = item->next;
+            size_t next = item->next_set(index + 1);
+            if (next < B) {
+                index = next;
+            } else {
+                item = item->next;
+                // only the sentinel can read as empty; it maps to (item, 0)
+                size_t first = item->next_set(0);
+                index = first < B ? first : 0;
+            }
             return *this;
         }
 
@@ -215,7 +2123,14 @@ public:
         }
 
         BaseIterator& operator--() {
-            item = item->prev;
+            size_t previous = (index == 0) ? B : item->prev_set(index - 1);
+            if (previous < B) {
+                index = previous;
+            } else {
+                item = item->prev;
+                size_t last = item->prev_set(B - 1);
+                index = last < B ? last : 0;
+            }
             return *this;
         }
 
@@ -226,11 +2141,11 @@ public:
         }
 
         bool operator==(const BaseIterator<const T>& other) const {
-            return item == other.item;
+            return item == other.item && index == other.index;
         }
 
         bool operator==(const BaseIterator<T>& other) const {
-            return item == other.item;
+            return item == other.item && index == other.index;
         }
     };
 
@@ -238,26 +2153,75 @@ public:
     using const_iterator = BaseIterator<const T>;
     using reverse_iterator = std::reverse_iterator<BaseIterator<T>>;
     using const_reverse_iterator = std::reverse_iterator<BaseIterator<const T>>;
+    using allocator_type = Allocator;
+
+    UnrolledList() = default;
+
+    explicit UnrolledList(const Allocator& allocator) : alloc(allocator) {}
+
+    UnrolledList(const UnrolledList& copy)
+        : UnrolledList(copy, NodeTraits::select_on_container_copy_construction(copy.alloc)) {}
+
+    UnrolledList(const UnrolledList& copy, const Allocator& allocator) : alloc(allocator) {
+        try {
+            for (auto it = copy.begin(); it != copy.end(); ++it) {
+                push_back(*it);
+            }
+        } catch (...) {
+            destroy();
+            throw;
+        }
+    }
+
+    UnrolledList(UnrolledList&& other) noexcept : alloc(std::move(other.alloc)) {
+        data = other.data;
+        sz = other.sz;
+        adopt_links();
+        other.data.prev = other.data.next = &other.data;
+        other.sz = 0;
+    }
+
+    UnrolledList& operator=(const UnrolledList& copy) {
+        if (this == &copy) {
+            return *this;
+        }
+        UnrolledList res(copy, std::allocator_traits<Allocator>::propagate_on_container_copy_assignment::value ?
+                               copy.alloc : alloc);
+        std::swap(alloc, res.alloc);
+        std::swap(data, res.data);
+        std::swap(sz, res.sz);
+        adopt_links();
+        res.adopt_links();
+        return *this;
+    }
+
+    allocator_type get_allocator() const {
+        return alloc;
+    }
+
+    size_t size() const {
+        return sz;
+    }
 
     iterator begin() {
-        return iterator(data.next);
+        return (sz == 0) ? end() : iterator(data.next, static_cast<Node*>(data.next)->next_set(0));
     }
     iterator end() {
-        return iterator(&data);
+        return iterator(&data, 0);
     }
 
     const_iterator begin() const {
-        return const_iterator(data.next);
+        return (sz == 0) ? end() : const_iterator(data.next, static_cast<Node*>(data.next)->next_set(0));
     }
     const_iterator end() const {
-        return const_iterator(&data);
+        return const_iterator(&data, 0);
     }
 
     const_iterator cbegin() const {
-        return const_iterator(data.next);
+        return begin();
     }
     const_iterator cend() const {
-        return const_iterator(&data);
+        return end();
     }
 
     reverse_iterator rbegin() {
@@ -268,60 +2232,105 @@ public:
     }
 
     const_reverse_iterator rbegin() const {
-        return const_reverse_iterator(cend());
+        return const_reverse_iterator(end());
     }
     const_reverse_iterator rend() const {
         return const_reverse_iterator(begin());
     }
 
-    const_reverse_iterator crbegin() const {
-        return const_reverse_iterator(cend());
+    template <typename... Args>
+    iterator emplace(const_iterator pos, Args&&... args) {
+        if (pos.item == &data) {
+            // append: top up the tail node or open a fresh one
+            if (sz > 0) {
+                Node* tail = static_cast<Node*>(data.prev);
+                size_t top = tail->prev_set(B - 1);
+                if (top + 1 < B) {
+                    construct_slot(tail, top + 1, std::forward<Args>(args)...);
+                    return iterator(tail, top + 1);
+                }
+            }
+            Node* fresh = make_node(data.prev, &data);
+            try {
+                construct_slot(fresh, 0, std::forward<Args>(args)...);
+            } catch (...) {
+                drop_node(fresh);
+                throw;
+            }
+            return iterator(fresh, 0);
+        }
+
+        Node* node = static_cast<Node*>(pos.item);
+        size_t at = pos.index;
+        // a free slot between the previous element and `at` keeps slot order
+        size_t low = (at == 0) ? B : node->prev_set(at - 1);
+        for (size_t j = at; j-- > 0;) {
+            if (low < B && j <= low) {
+                break;
+            }
+            if (!node->test(j)) {
+                construct_slot(node, j, std::forward<Args>(args)...);
+                return iterator(node, j);
+            }
+        }
+        // no gap: move the tail slots [at, B) into a fresh node, freeing `at`
+        Node* fresh = make_node(node, node->next);
+        size_t moved = 0;
+        for (size_t j = node->next_set(at); j < B; j = node->next_set(j + 1)) {
+            construct_slot(fresh, moved, std::move(*node->slot(j)));
+            destroy_slot(node, j);
+            ++moved;
+        }
+        construct_slot(node, at, std::forward<Args>(args)...);
+        return iterator(node, at);
     }
-    const_reverse_iterator crend() const {
-        return const_reverse_iterator(cbegin());
+
+    iterator insert(const_iterator pos, const T& value) {
+        return emplace(pos, value);
     }
 
+    iterator insert(const_iterator pos, T&& value) {
+        return emplace(pos, std::move(value));
+    }
 
     void push_back(const T& value) {
-        insert(end(), value);
+        emplace(end(), value);
     }
 
-    void pop_back() {
-        erase(--end());
+    void push_back(T&& value) {
+        emplace(end(), std::move(value));
     }
 
     void push_front(const T& value) {
-        insert(begin(), value);
+        emplace(begin(), value);
     }
 
-    void pop_front() {
-        erase(begin());
+    void push_front(T&& value) {
+        emplace(begin(), std::move(value));
     }
 
-    iterator insert(const_iterator iter, const T& value) {
-        Node* it = NodeTraits::allocate(alloc, 1);
-        try {
-            NodeTraits::construct(alloc, it, iter.item->prev, iter.item, value);
-        } catch (...) {
-            NodeTraits::deallocate(alloc, it, 1);
-            throw;
-        }
+    template <typename... Args>
+    T& emplace_back(Args&&... args) {
+        return *emplace(end(), std::forward<Args>(args)...);
+    }
 
-        iter.item->prev->next = it;
-        iter.item->prev = it;
-        ++sz;
-        return iterator(it);
+    iterator erase(const_iterator pos) {
+        iterator next(pos.item, pos.index);
+        ++next;
+        Node* node = static_cast<Node*>(pos.item);
+        destroy_slot(node, pos.index);
+        if (node->occupied == 0) {
+            drop_node(node);
+        }
+        return next;
     }
 
-    iterator erase(const_iterator iter) {
-        BaseNode* it = iter.item->next;
-        it->prev = iter.item->prev;
-        iter.item->prev->next = it;
+    void pop_back() {
+        erase(--end());
+    }
 
-        NodeTraits::destroy(alloc, static_cast<Node*>(iter.item));
-        NodeTraits::deallocate(alloc, static_cast<Node*>(iter.item), 1);
-        --sz;
-        return it;
+    void pop_front() {
+        erase(begin());
     }
 
     void clear() {
@@ -330,7 +2339,151 @@ public:
         sz = 0;
     }
 
-    ~List() {
+    ~UnrolledList() {
         destroy();
     }
 };
+
+
+// Multi-producer single-consumer queue over the same Node/BaseNode plumbing
+// as List (Vyukov's intrusive MPSC design).  Producers publish with one
+// atomic exchange on head plus one store of the forward link — no locks, no
+// CAS loops — and the single consumer follows next pointers from its own
+// cursor.  A drained batch can be spliced wholesale into a List for ordinary
+// in-order processing, so the hot path never copies elements.
+template <typename T, typename Allocator = std::allocator<T>>
+class MpscQueue {
+    using ListType = List<T, Allocator>;
+    using BaseNode = typename ListType::BaseNode;
+    using Node = typename ListType::Node;
+    using NodeAlloc = typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+    using NodeTraits = typename std::allocator_traits<NodeAlloc>;
+
+    [[ no_unique_address ]] NodeAlloc alloc;
+    BaseNode stub;
+    std::atomic<BaseNode*> head;  // most recently pushed node
+    BaseNode* tail;               // consumer cursor: oldest unconsumed node
+
+    // next is a plain pointer shared with List, so the producer/consumer
+    // handoff goes through atomic_ref instead of widening BaseNode.
+    static BaseNode* next_of(BaseNode* node) {
+        return std::atomic_ref<BaseNode*>(node->next).load(std::memory_order_acquire);
+    }
+
+    void push_link(BaseNode* node) {
+        node->next = nullptr;
+        BaseNode* prev = head.exchange(node, std::memory_order_acq_rel);
+        // the queue is momentarily split until this store lands; the
+        // consumer treats the missing link as "empty for now"
+        std::atomic_ref<BaseNode*>(prev->next).store(node, std::memory_order_release);
+    }
+
+    // Detaches and returns the oldest node, or nullptr when the queue is
+    // empty or a producer sits in the window between its exchange and the
+    // link store.  Never blocks or spins: the consumer stays wait-free.
+    BaseNode* pop_node() {
+        BaseNode* first = tail;
+        BaseNode* next = next_of(first);
+        if (first == &stub) {
+            if (next == nullptr) {
+                return nullptr;
+            }
+            tail = next;
+            first = next;
+            next = next_of(first);
+        }
+        if (next != nullptr) {
+            tail = next;
+            return first;
+        }
+        if (first != head.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        // first is the last node: park the stub behind it so the queue is
+        // never observed completely unlinked, then detach
+        push_link(&stub);
+        next = next_of(first);
+        if (next == nullptr) {
+            return nullptr;
+        }
+        tail = next;
+        return first;
+    }
+
+public:
+    MpscQueue() : head(&stub), tail(&stub) {
+        stub.next = nullptr;
+    }
+
+    explicit MpscQueue(const Allocator& allocator) : alloc(allocator), head(&stub), tail(&stub) {
+        stub.next = nullptr;
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    // Safe from any thread, any number of threads.
+    template <typename... Args>
+    void emplace(Args&&... args) {
+        Node* node = NodeTraits::allocate(alloc, 1);
+        if constexpr (std::is_nothrow_constructible_v<T, Args...>) {
+            NodeTraits::construct(alloc, node, nullptr, nullptr, std::forward<Args>(args)...);
+        } else {
+            try {
+                NodeTraits::construct(alloc, node, nullptr, nullptr, std::forward<Args>(args)...);
+            } catch (...) {
+                NodeTraits::deallocate(alloc, node, 1);
+                throw;
+            }
+        }
+        push_link(node);
+    }
+
+    void push(const T& value) {
+        emplace(value);
+    }
+
+    void push(T&& value) {
+        emplace(std::move(value));
+    }
+
+    // Consumer-only.  Returns false when nothing is ready, including the
+    // momentary window where a producer has swapped head but not yet
+    // published its link — callers are expected to poll or back off.
+    bool try_pop(T& value) {
+        BaseNode* node = pop_node();
+        if (node == nullptr) {
+            return false;
+        }
+        value = std::move(static_cast<Node*>(node)->key);
+        NodeTraits::destroy(alloc, static_cast<Node*>(node));
+        NodeTraits::deallocate(alloc, static_cast<Node*>(node), 1);
+        return true;
+    }
+
+    // Consumer-only.  Splices every node currently visible onto the back of
+    // `out`, oldest first, without copying elements; returns how many moved.
+    // `out` must use an allocator equal to the queue's, since it frees the
+    // nodes when they are erased or the list dies.
+    size_t drain_to(ListType& out) {
+        size_t drained = 0;
+        out.note_write();
+        while (BaseNode* node = pop_node()) {
+            node->prev = out.data.prev;
+            node->next = &out.data;
+            out.data.prev->next = node;
+            out.data.prev = node;
+            ++out.sz;
+            ++drained;
+        }
+        return drained;
+    }
+
+    // No producers may be active once destruction starts.
+    ~MpscQueue() {
+        while (BaseNode* node = pop_node()) {
+            NodeTraits::destroy(alloc, static_cast<Node*>(node));
+            NodeTraits::deallocate(alloc, static_cast<Node*>(node), 1);
+        }
+    }
+};
@@ -1,4 +1,7 @@
 #include "tiny_test.hpp"
+
+// exercise the instrumented allocator paths in the test build
+#define STACKALLOC_STATS
 #include "stackallocator.h"
 
 #include <algorithm>
@@ -10,6 +13,10 @@
 #include <random>
 #include <compare>
 #include <list>
+#include <thread>
+#include <atomic>
+#include <utility>
+#include <cstdlib>
 
 
 using testing::make_test;
@@ -85,6 +92,32 @@ struct ExceptionalAllocator {
     bool operator==(const ExceptionalAllocator& other) const = default;
 };
 
+// A stateful allocator that propagates on copy assignment; two instances
+// with different tags compare unequal, which steers List's copy assignment
+// into the rebuild-and-swap branch.
+template<typename T>
+struct TaggedAllocator {
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+
+    int m_tag;
+    std::allocator<T> m_actual_allocator;
+
+    TaggedAllocator(int tag) : m_tag(tag) {}
+    template<typename U>
+    TaggedAllocator(const TaggedAllocator<U>& other) : m_tag(other.m_tag) {}
+
+    T* allocate(size_t n) {
+        return m_actual_allocator.allocate(n);
+    }
+
+    void deallocate(T* pointer, size_t n) {
+        return m_actual_allocator.deallocate(pointer, n);
+    }
+
+    bool operator==(const TaggedAllocator& other) const = default;
+};
+
 struct Fragile {
     Fragile(int durability, int data): durability(durability), data(data) {}
     ~Fragile() = default;
@@ -215,8 +248,35 @@ struct CheckIter{
     static_assert(std::is_same_v<decltype(std::declval<iter>() != std::declval<iter>()), bool>);
 };
 
+// With std::allocator the core List operations run in constant
+// expressions, so small list-derived tables can be computed entirely at
+// compile time and baked into the binary.
+constexpr size_t constexpr_table_sum() {
+    List<size_t> list;
+    for (size_t i = 0; i < 10; ++i) {
+        list.push_back(i);
+    }
+    list.insert(list.begin(), 100);   // [100, 0..9]
+    list.erase(std::next(list.begin()));  // [100, 1..9]
+    list.push_front(1);               // [1, 100, 1..9]
+    list.pop_back();                  // [1, 100, 1..8]
+    List<size_t> copy(list);
+    size_t sum = copy.size();
+    for (size_t item : list) {
+        sum += item;
+    }
+    return sum;
+}
+
+static_assert(constexpr_table_sum() == 10 + 1 + 100 + 36);
+
 TestGroup create_constructor_tests() {
     return { "constructors",
+        make_test<PrettyTest>("constexpr list", [](auto& test){
+            // the real check is the static_assert above; this just shows
+            // both evaluations agree
+            test.equals(constexpr_table_sum(), size_t(147));
+        }),
         make_test<PrettyTest>("default", [](auto& test){
             List<int> defaulted;
             test.check(defaulted.size() == 0);
@@ -242,6 +302,26 @@ TestGroup create_constructor_tests() {
                         return item.data == DefaultConstructible::default_data;
             }));
         }),
+        make_test<PrettyTest>("from range", [](auto& test){
+            List<size_t> list(Iotaterator<size_t>{0}, Iotaterator<size_t>{medium_size});
+            test.equals(list.size(), medium_size);
+            test.check(std::equal(list.begin(), list.end(), Iotaterator<size_t>{0}));
+            std::vector<int> source{3, 1, 4, 1, 5};
+            List<int> from_vector(source.begin(), source.end());
+            test.check(std::equal(from_vector.begin(), from_vector.end(), source.begin(), source.end()));
+        }),
+        make_test<PrettyTest>("assign", [](auto& test){
+            List<size_t> list(small_size, size_t(0));
+            list.assign(Iotaterator<size_t>{0}, Iotaterator<size_t>{medium_size});
+            test.equals(list.size(), medium_size);
+            test.check(std::equal(list.begin(), list.end(), Iotaterator<size_t>{0}));
+            // shrinking reuses the surviving nodes and erases the tail
+            list.assign(Iotaterator<size_t>{0}, Iotaterator<size_t>{small_size});
+            test.equals(list.size(), small_size);
+            test.check(std::equal(list.begin(), list.end(), Iotaterator<size_t>{0}));
+            list.assign(size_t(small_size), size_t(7));
+            test.check(std::all_of(list.begin(), list.end(), [](size_t item) { return item == 7; }));
+        }),
         make_test<PrettyTest>("assignment", [](auto& test){
             List<int> first(small_size, nontrivial_int);
             const auto second_size = small_size - 1;
@@ -258,6 +338,30 @@ TestGroup create_constructor_tests() {
 #endif
             test.check((first.size() == second.size()) && (first.size() == second_size) && std::equal(first.begin(), first.end(), second.begin()));
         }),
+        make_test<PrettyTest>("assignment reuses nodes", [](auto& test){
+            using data_t = size_t;
+            using alloc = ExceptionalAllocator<data_t>;
+            auto destination = List<data_t, alloc>(alloc(small_size));
+            for (size_t i = 0; i < small_size; ++i) {
+                destination.push_back(0);
+            }
+            auto source = List<data_t, alloc>(alloc(small_size));
+            for (size_t i = 0; i < small_size; ++i) {
+                source.push_back(i);
+            }
+            // both budgets are spent; same-size assignment must not allocate
+            destination = source;
+            test.equals(destination.size(), small_size);
+            test.check(std::equal(destination.begin(), destination.end(), Iotaterator<size_t>{0}));
+            // shrinking assignment frees the tail, still no allocations
+            auto shorter = List<data_t, alloc>(alloc(small_size / 2));
+            for (size_t i = 0; i < small_size / 2; ++i) {
+                shorter.push_back(i);
+            }
+            destination = shorter;
+            test.equals(destination.size(), small_size / 2);
+            test.check(std::equal(destination.begin(), destination.end(), Iotaterator<size_t>{0}));
+        }),
         make_test<SimpleTest>("static asserts", []{
             using T1 = int;
             using T2 = NotDefaultConstructible;
@@ -277,8 +381,176 @@ TestGroup create_constructor_tests() {
     };
 }
 
+TestGroup create_move_tests() {
+    return { "move and swap",
+        make_test<PrettyTest>("move constructor", [](auto& test){
+            List<NotDefaultConstructible> source;
+            for (int i = 0; i < int(small_size); ++i) {
+                source.push_back(NotDefaultConstructible(i));
+            }
+            List<NotDefaultConstructible> destination = std::move(source);
+            test.equals(destination.size(), small_size);
+            test.equals(source.size(), size_t(0));
+            test.check(std::equal(destination.begin(), destination.end(), Iotaterator<int>{0},
+                        [](const auto& item, int expected) { return item.data == expected; }));
+            // moved-from list is empty but usable
+            source.push_back(NotDefaultConstructible(42));
+            test.equals(source.size(), size_t(1));
+        }),
+        make_test<PrettyTest>("move assignment", [](auto& test){
+            List<int> first(small_size, nontrivial_int);
+            List<int> second(medium_size, nontrivial_int + 1);
+            first = std::move(second);
+            test.equals(first.size(), medium_size);
+            test.check(std::all_of(first.begin(), first.end(), [](int item) { return item == nontrivial_int + 1; }));
+        }),
+        make_test<PrettyTest>("swap", [](auto& test){
+            List<int> first(small_size, nontrivial_int);
+            List<int> second(medium_size, nontrivial_int + 1);
+            first.swap(second);
+            test.equals(first.size(), medium_size);
+            test.equals(second.size(), small_size);
+            test.check(std::all_of(first.begin(), first.end(), [](int item) { return item == nontrivial_int + 1; }));
+            test.check(std::all_of(second.begin(), second.end(), [](int item) { return item == nontrivial_int; }));
+            List<int> empty;
+            first.swap(empty);
+            test.equals(first.size(), size_t(0));
+            test.equals(empty.size(), medium_size);
+        }),
+        make_test<PrettyTest>("move does not allocate", [](auto& test){
+            using data_t = size_t;
+            using alloc = ExceptionalAllocator<data_t>;
+            auto list = List<data_t, alloc>(alloc(small_size));
+            for (size_t i = 0; i < small_size; ++i) {
+                list.push_back(i);
+            }
+            // the allocator budget is exhausted: relink-only operations must still work
+            auto moved = std::move(list);
+            test.equals(moved.size(), small_size);
+            moved.swap(list);
+            test.equals(list.size(), small_size);
+            test.check(std::equal(list.begin(), list.end(), Iotaterator<size_t>{0}));
+        }),
+        make_test<SimpleTest>("static asserts", []{
+            static_assert(std::is_nothrow_move_constructible_v<List<int>>, "should have noexcept move constructor");
+            static_assert(std::is_nothrow_move_assignable_v<List<int>>, "should have noexcept move assignment");
+            static_assert(std::is_nothrow_swappable_v<List<int>>, "should have noexcept swap");
+            return true;
+        })
+    };
+}
+
 TestGroup create_modification_tests() {
     return { "modification",
+        make_test<PrettyTest>("emplace", [](auto& test) {
+            List<NotDefaultConstructible> list;
+            list.emplace_back(1);
+            list.emplace_front(0);
+            auto& back = list.emplace_back(3);
+            test.equals(back.data, 3);
+            auto iter = list.end();
+            --iter;
+            auto inserted = list.emplace(iter, 2);
+            test.equals(inserted->data, 2);
+            test.equals(list.size(), size_t(4));
+            test.check(std::equal(list.begin(), list.end(), Iotaterator<int>{0},
+                        [](const auto& item, int expected) { return item.data == expected; }));
+        }),
+        make_test<PrettyTest>("rvalue overloads", [](auto& test) {
+            List<std::unique_ptr<int>> list;
+            list.push_back(std::make_unique<int>(1));
+            list.push_front(std::make_unique<int>(0));
+            list.insert(list.end(), std::make_unique<int>(2));
+            test.equals(list.size(), size_t(3));
+            test.check(std::equal(list.begin(), list.end(), Iotaterator<int>{0},
+                        [](const auto& item, int expected) { return *item == expected; }));
+        }),
+        make_test<PrettyTest>("prefetching traversal", [](auto& test) {
+            List<size_t> list;
+            for (size_t i = 0; i < medium_size; ++i) {
+                list.push_back(i);
+            }
+            size_t sum = 0;
+            std::as_const(list).for_each([&sum](const size_t& item) { sum += item; });
+            test.equals(sum, medium_size * (medium_size - 1) / 2);
+
+            list.for_each([](size_t& item) { item *= 2; });
+            test.check(std::equal(list.begin(), list.end(), Iotaterator<size_t>{0},
+                        [](size_t item, size_t expected) { return item == 2 * expected; }));
+
+            size_t seen = 0;
+            auto stop = list.for_each_n(small_size, [&seen](const size_t&) { ++seen; });
+            test.equals(seen, small_size);
+            test.check(stop == std::next(list.begin(), small_size));
+            // count past the end clamps to the list
+            seen = 0;
+            auto all = list.for_each_n(2 * medium_size, [&seen](const size_t&) { ++seen; });
+            test.equals(seen, medium_size);
+            test.check(all == list.end());
+        }),
+        make_test<PrettyTest>("snapshot", [](auto& test) {
+            List<size_t> list;
+            for (size_t i = 0; i < medium_size; ++i) {
+                list.push_back(i);
+            }
+            auto before = list.snapshot();
+            // snapshots between writes share one cached copy
+            test.check(list.snapshot() == before);
+            test.equals(before->size(), medium_size);
+            list.push_back(medium_size);
+            // the view is immutable; the write only drops the cache
+            test.equals(before->size(), medium_size);
+            auto after = list.snapshot();
+            test.check(after != before);
+            test.equals(after->size(), medium_size + 1);
+            test.check(std::equal(after->begin(), after->end(), Iotaterator<size_t>{0}));
+            // snapshots outlive any reshaping of the source
+            list.clear();
+            test.equals(after->size(), medium_size + 1);
+            test.check(std::equal(before->begin(), before->end(), Iotaterator<size_t>{0}));
+        }),
+        make_test<PrettyTest>("snapshot dropped by propagating assignment", [](auto& test) {
+            using alloc = TaggedAllocator<size_t>;
+            auto first = List<size_t, alloc>(alloc(1));
+            auto second = List<size_t, alloc>(alloc(2));
+            for (size_t i = 0; i < medium_size; ++i) {
+                first.push_back(i);
+            }
+            second.push_back(medium_size);
+            auto before = first.snapshot();
+            // unequal propagating allocators take the rebuild-and-swap
+            // branch, which must drop the cache like any other write
+            first = second;
+            test.check(first.get_allocator() == second.get_allocator());
+            auto after = first.snapshot();
+            test.check(after != before);
+            test.equals(after->size(), size_t(1));
+            test.equals(*after->begin(), medium_size);
+            // the stale view itself stays intact
+            test.equals(before->size(), medium_size);
+        }),
+        make_test<PrettyTest>("parallel for_each", [](auto& test) {
+            List<size_t> list;
+            for (size_t i = 0; i < big_size; ++i) {
+                list.push_back(i);
+            }
+            std::atomic<size_t> sum{0};
+            std::as_const(list).parallel_for_each(4, [&sum](const size_t& item) {
+                sum.fetch_add(item, std::memory_order_relaxed);
+            });
+            test.equals(sum.load(), big_size * (big_size - 1) / 2);
+            // segments are disjoint, so mutation needs no synchronization
+            list.parallel_for_each(4, [](size_t& item) { item += 1; });
+            test.check(std::equal(list.begin(), list.end(), Iotaterator<size_t>{1}));
+            // degenerate cases fall back to the serial walk
+            List<size_t> tiny;
+            tiny.push_back(5);
+            tiny.parallel_for_each(8, [](size_t& item) { item *= 2; });
+            test.equals(*tiny.begin(), size_t(10));
+            List<size_t> empty;
+            empty.parallel_for_each(8, [](size_t&) {});
+            test.equals(empty.size(), size_t(0));
+        }),
         make_test<PrettyTest>("exceptions", [](auto& test) {
             try {
                 List<Counted<small_size>> big_list(medium_size);
@@ -314,6 +586,367 @@ TestGroup create_modification_tests() {
     };
 }
 
+TestGroup create_node_surgery_tests() {
+    return { "node surgery",
+        make_test<PrettyTest>("splice", [](auto& test) {
+            using data_t = size_t;
+            using alloc = ExceptionalAllocator<data_t>;
+            auto first = List<data_t, alloc>(alloc(small_size));
+            auto second = List<data_t, alloc>(alloc(small_size));
+            for (size_t i = 0; i < small_size / 2; ++i) {
+                first.push_back(i);
+            }
+            for (size_t i = small_size / 2; i < small_size; ++i) {
+                second.push_back(i);
+            }
+            // the budget of both allocators is spent: splice must not allocate
+            first.splice(first.end(), second);
+            test.equals(first.size(), small_size);
+            test.equals(second.size(), size_t(0));
+            test.check(std::equal(first.begin(), first.end(), Iotaterator<size_t>{0}));
+
+            // single element: move the front to the back of the other list
+            second.splice(second.begin(), first, first.begin());
+            test.equals(second.size(), size_t(1));
+            test.equals(first.size(), small_size - 1);
+            test.equals(*second.begin(), size_t(0));
+
+            // range: take everything back
+            second.splice(second.end(), first, first.begin(), first.end());
+            test.equals(second.size(), small_size);
+            test.equals(first.size(), size_t(0));
+            test.check(std::equal(second.begin(), second.end(), Iotaterator<size_t>{0}));
+        }),
+        make_test<PrettyTest>("sort", [](auto& test) {
+            std::mt19937 generator(514);
+            std::vector<int> expected(big_size);
+            for (auto& item : expected) {
+                item = int(generator() % big_size);
+            }
+            List<int> list;
+            for (int item : expected) {
+                list.push_back(item);
+            }
+            std::sort(expected.begin(), expected.end());
+            list.sort();
+            test.equals(list.size(), big_size);
+            test.check(std::equal(list.begin(), list.end(), expected.begin(), expected.end()));
+            list.sort(std::greater<int>());
+            test.check(std::equal(list.begin(), list.end(), expected.rbegin(), expected.rend()));
+            // sorting must not allocate
+            using alloc = ExceptionalAllocator<int>;
+            auto drained = List<int, alloc>(alloc(small_size));
+            for (size_t i = 0; i < small_size; ++i) {
+                drained.push_back(int(small_size - i));
+            }
+            drained.sort();
+            test.check(std::is_sorted(drained.begin(), drained.end()));
+        }),
+        make_test<PrettyTest>("sort stability", [](auto& test) {
+            List<std::pair<int, int>> list;
+            std::mt19937 generator(117);
+            std::vector<std::pair<int, int>> expected;
+            for (int i = 0; i < int(medium_size); ++i) {
+                expected.emplace_back(int(generator() % 4), i);
+                list.push_back(expected.back());
+            }
+            auto by_first = [](const auto& a, const auto& b) { return a.first < b.first; };
+            std::stable_sort(expected.begin(), expected.end(), by_first);
+            list.sort(by_first);
+            test.check(std::equal(list.begin(), list.end(), expected.begin(), expected.end()));
+        }),
+        make_test<PrettyTest>("reverse", [](auto& test) {
+            List<int> list;
+            for (int i = 0; i < int(medium_size); ++i) {
+                list.push_back(i);
+            }
+            list.reverse();
+            test.equals(list.size(), medium_size);
+            test.check(std::equal(list.rbegin(), list.rend(), Iotaterator<int>{0}));
+            List<int> empty;
+            empty.reverse();
+            test.equals(empty.size(), size_t(0));
+        }),
+        make_test<PrettyTest>("merge", [](auto& test) {
+            List<int> even;
+            List<int> odd;
+            for (int i = 0; i < int(medium_size); ++i) {
+                (i % 2 == 0 ? even : odd).push_back(i);
+            }
+            even.merge(odd);
+            test.equals(even.size(), medium_size);
+            test.equals(odd.size(), size_t(0));
+            test.check(std::equal(even.begin(), even.end(), Iotaterator<int>{0}));
+            even.merge(odd);
+            test.equals(even.size(), medium_size);
+        }),
+        make_test<PrettyTest>("unique and remove_if", [](auto& test) {
+            List<int> list;
+            for (int i = 0; i < int(small_size); ++i) {
+                list.push_back(i);
+                list.push_back(i);
+            }
+            test.equals(list.unique(), small_size);
+            test.check(std::equal(list.begin(), list.end(), Iotaterator<int>{0}));
+            auto removed = list.remove_if([](int item) { return item % 2 != 0; });
+            test.equals(removed, small_size / 2);
+            test.check(std::all_of(list.begin(), list.end(), [](int item) { return item % 2 == 0; }));
+        }),
+        make_test<PrettyTest>("splice within one list", [](auto& test) {
+            List<int> list;
+            for (int i = 0; i < 5; ++i) {
+                list.push_back(i);
+            }
+            // rotate: move the front element to the end
+            list.splice(list.end(), list, list.begin());
+            test.equals(list.size(), size_t(5));
+            std::vector<int> expected{1, 2, 3, 4, 0};
+            test.check(std::equal(list.begin(), list.end(), expected.begin(), expected.end()));
+            // no-op splices
+            list.splice(list.begin(), list, list.begin());
+            test.equals(list.size(), size_t(5));
+            test.check(std::equal(list.begin(), list.end(), expected.begin(), expected.end()));
+        }),
+        make_test<PrettyTest>("find, count and contains", [](auto& test) {
+            using data_t = size_t;
+            const size_t nbytes = (medium_size + 2) * (sizeof(data_t) + 2 * sizeof(void*));
+            using alloc = StackAllocator<data_t, nbytes>;
+            auto storage = StackStorage<nbytes>();
+            // arena-backed push_back lays nodes out consecutively, so this
+            // exercises the dense-run kernel, not just the scalar fallback
+            auto list = List<data_t, alloc>(alloc(storage));
+            for (size_t i = 0; i < medium_size; ++i) {
+                list.push_back(i % small_size);
+            }
+            // i % 17 over 100 pushes: 0..14 appear six times, 15..16 five
+            test.equals(list.count(1), size_t(6));
+            test.equals(list.count(16), size_t(5));
+            test.check(list.contains(16));
+            test.check(!list.contains(small_size));
+            auto it = list.find(5);
+            test.check(it == std::next(list.begin(), 5));
+            *it = small_size;
+            test.check(list.contains(small_size));
+            test.check(std::as_const(list).find(small_size) == std::next(list.cbegin(), 5));
+            *it = 5;
+            // punch holes so the kernel hops across run boundaries too
+            list.remove_if([](size_t item) { return item % 2 == 0; });
+            test.equals(list.size(), size_t(47));
+            test.equals(list.count(3), size_t(6));
+            test.equals(list.count(15), size_t(5));
+            test.check(!list.contains(2));
+        })
+    };
+}
+
+TestGroup create_capacity_tests() {
+    return { "capacity",
+        make_test<PrettyTest>("resize", [](auto& test) {
+            List<int> list;
+            list.resize(medium_size, nontrivial_int);
+            test.equals(list.size(), medium_size);
+            test.check(std::all_of(list.begin(), list.end(), [](int item) { return item == nontrivial_int; }));
+            list.resize(small_size);
+            test.equals(list.size(), small_size);
+            list.resize(medium_size);
+            test.equals(list.size(), medium_size);
+            auto tail = list.begin();
+            std::advance(tail, ptrdiff_t(small_size));
+            test.check(std::all_of(tail, list.end(), [](int item) { return item == 0; }));
+        }),
+        make_test<PrettyTest>("reserve_nodes", [](auto& test) {
+            using data_t = size_t;
+            using alloc = ExceptionalAllocator<data_t>;
+            auto list = List<data_t, alloc>(alloc(small_size));
+            // spend the whole allocator budget on the reservation...
+            list.reserve_nodes(small_size);
+            // ...then fill with no allocator traffic at all
+            for (size_t i = 0; i < small_size; ++i) {
+                list.push_back(i);
+            }
+            test.equals(list.size(), small_size);
+            test.check(std::equal(list.begin(), list.end(), Iotaterator<size_t>{0}));
+            try {
+                list.push_back({});
+                test.fail();
+            } catch (CustomAllocatorException& e) { }
+        }),
+        make_test<PrettyTest>("freeze and thaw", [](auto& test) {
+            List<size_t> list;
+            for (size_t i = 0; i < medium_size; ++i) {
+                list.push_back(i);
+            }
+            auto frozen = list.freeze();
+            test.equals(list.size(), size_t(0));
+            test.equals(frozen.size(), medium_size);
+            test.equals(frozen[small_size], small_size);
+            test.check(std::equal(frozen.begin(), frozen.end(), Iotaterator<size_t>{0}));
+            list.thaw(std::move(frozen));
+            test.equals(frozen.size(), size_t(0));
+            test.equals(list.size(), medium_size);
+            test.check(std::equal(list.begin(), list.end(), Iotaterator<size_t>{0}));
+            // empty freeze allocates nothing
+            List<size_t> empty;
+            auto nothing = empty.freeze();
+            test.equals(nothing.size(), size_t(0));
+        }),
+        make_test<PrettyTest>("freeze moves move-only elements", [](auto& test) {
+            List<std::unique_ptr<int>> owners;
+            for (int i = 0; i < int(small_size); ++i) {
+                owners.push_back(std::make_unique<int>(i));
+            }
+            auto cold = owners.freeze();
+            test.equals(cold.size(), small_size);
+            test.equals(*cold[3], 3);
+            owners.thaw(std::move(cold));
+            test.equals(owners.size(), small_size);
+            test.equals(**std::next(owners.begin(), 3), 3);
+        })
+    };
+}
+
+TestGroup create_compact_tests() {
+    return { "compact list",
+        make_test<PrettyTest>("offset links", [](auto& test) {
+            using data_t = size_t;
+            const size_t nbytes = 1 << 16;
+            auto storage = StackStorage<nbytes>();
+            auto list = CompactList<data_t, nbytes>(storage);
+            for (size_t i = 0; i < medium_size; ++i) {
+                list.push_back(i);
+            }
+            test.equals(list.size(), medium_size);
+            test.check(std::equal(list.begin(), list.end(), Iotaterator<data_t>{0}));
+            test.check(std::equal(list.rbegin(), list.rend(), Iotaterator<data_t>{0},
+                        [](data_t item, data_t expected) { return item == medium_size - 1 - expected; }));
+            auto iter = list.begin();
+            std::advance(iter, 10);
+            iter = list.erase(iter);
+            test.equals(*iter, data_t(11));
+            list.insert(iter, data_t(10));
+            test.equals(list.size(), medium_size);
+            test.check(std::equal(list.begin(), list.end(), Iotaterator<data_t>{0}));
+            auto moved = std::move(list);
+            test.equals(moved.size(), medium_size);
+            test.equals(list.size(), size_t(0));
+            test.check(std::equal(moved.begin(), moved.end(), Iotaterator<data_t>{0}));
+        })
+    };
+}
+
+TestGroup create_small_buffer_tests() {
+    return { "small buffer",
+        make_test<PrettyTest>("inline nodes avoid the allocator", [](auto& test) {
+            using data_t = size_t;
+            using alloc = ExceptionalAllocator<data_t>;
+            // a zero budget: any allocator call throws immediately
+            auto list = List<data_t, alloc, 4>(alloc(0));
+            for (size_t i = 0; i < 4; ++i) {
+                list.push_back(i);
+            }
+            test.equals(list.size(), size_t(4));
+            test.check(std::equal(list.begin(), list.end(), Iotaterator<data_t>{0}));
+            try {
+                list.push_back(4);
+                test.fail();
+            } catch (CustomAllocatorException& e) { }
+            // erased inline slots are reused
+            list.pop_front();
+            list.push_back(4);
+            test.equals(list.size(), size_t(4));
+            test.check(std::equal(list.begin(), list.end(), Iotaterator<data_t>{1}));
+        }),
+        make_test<PrettyTest>("inline nodes survive transfers", [](auto& test) {
+            using small_list = List<int, std::allocator<int>, 4>;
+            small_list first;
+            for (int i = 0; i < 3; ++i) {
+                first.push_back(i);
+            }
+            small_list second = std::move(first);
+            test.equals(second.size(), size_t(3));
+            test.check(std::equal(second.begin(), second.end(), Iotaterator<int>{0}));
+            small_list third;
+            third.push_back(3);
+            third.swap(second);
+            test.equals(third.size(), size_t(3));
+            test.equals(second.size(), size_t(1));
+            // splice out of a list whose nodes are inline
+            third.splice(third.end(), second, second.begin());
+            test.equals(third.size(), size_t(4));
+            test.check(std::equal(third.begin(), third.end(), Iotaterator<int>{0}));
+            small_list sorted_rest;
+            sorted_rest.push_back(10);
+            sorted_rest.push_back(12);
+            third.push_back(11);
+            third.sort();
+            third.merge(sorted_rest);
+            test.equals(third.size(), size_t(7));
+            test.check(std::is_sorted(third.begin(), third.end()));
+        })
+    };
+}
+
+TestGroup create_unrolled_tests() {
+    return { "unrolled list",
+        make_test<PrettyTest>("push and traverse", [](auto& test) {
+            UnrolledList<size_t, 8> list;
+            for (size_t i = 0; i < big_size; ++i) {
+                list.push_back(i);
+            }
+            test.equals(list.size(), big_size);
+            test.check(std::equal(list.begin(), list.end(), Iotaterator<size_t>{0}));
+            test.check(std::equal(list.rbegin(), list.rend(), Iotaterator<size_t>{0},
+                        [](size_t item, size_t expected) { return item == big_size - 1 - expected; }));
+        }),
+        make_test<PrettyTest>("push_front", [](auto& test) {
+            UnrolledList<int, 4> list;
+            for (int i = int(medium_size); i-- > 0;) {
+                list.push_front(i);
+            }
+            test.equals(list.size(), medium_size);
+            test.check(std::equal(list.begin(), list.end(), Iotaterator<int>{0}));
+            test.check(std::equal(list.rbegin(), list.rend(), Iotaterator<int>{0},
+                        [](int item, int expected) { return item == int(medium_size) - 1 - expected; }));
+        }),
+        make_test<PrettyTest>("insert and erase", [](auto& test) {
+            UnrolledList<size_t, 8> list;
+            std::list<size_t> mirror;
+            std::mt19937 generator(719);
+            for (size_t i = 0; i < big_size; ++i) {
+                size_t position = mirror.empty() ? 0 : generator() % mirror.size();
+                auto iter = list.begin();
+                auto mirror_iter = mirror.begin();
+                std::advance(iter, ptrdiff_t(position));
+                std::advance(mirror_iter, ptrdiff_t(position));
+                if (i % 3 != 0 || mirror.empty()) {
+                    list.insert(iter, i);
+                    mirror.insert(mirror_iter, i);
+                } else {
+                    list.erase(iter);
+                    mirror.erase(mirror_iter);
+                }
+            }
+            test.equals(list.size(), mirror.size());
+            test.check(std::equal(list.begin(), list.end(), mirror.begin(), mirror.end()));
+        }),
+        make_test<PrettyTest>("copy and move", [](auto& test) {
+            UnrolledList<int, 4> list;
+            for (int i = 0; i < int(medium_size); ++i) {
+                list.push_back(i);
+            }
+            auto copy = list;
+            test.check(std::equal(copy.begin(), copy.end(), list.begin(), list.end()));
+            auto moved = std::move(list);
+            test.equals(moved.size(), medium_size);
+            test.check(std::equal(moved.begin(), moved.end(), copy.begin(), copy.end()));
+            copy.clear();
+            test.equals(copy.size(), size_t(0));
+            copy = moved;
+            test.equals(copy.size(), medium_size);
+        })
+    };
+}
+
 TestGroup create_allocator_tests() {
     return {"allocator",
         make_test<PrettyTest>("exceptional allocator", [](auto& test) {
@@ -368,6 +1001,173 @@ TestGroup create_allocator_tests() {
             test.check(std::equal(big_list.rbegin(), big_list.rend(), Iotaterator<data_t>{data_t(0)}));
         }),
 
+        make_test<PrettyTest>("pool allocator recycles slots", [](auto& test){
+            using data_t = size_t;
+            // room for the window plus a little slack, far less than the
+            // big_size iterations the loop below pushes through it
+            const size_t nbytes = (small_size + 2) * (sizeof(data_t) + 2 * sizeof(void*) + sizeof(void*));
+            using alloc = PoolAllocator<data_t, nbytes>;
+            auto storage = PoolStorage<nbytes>();
+            auto window = List<data_t, alloc>(alloc(storage));
+            for (size_t i = 0; i < big_size; ++i) {
+                window.push_back(i);
+                if (window.size() > small_size) {
+                    window.pop_front();
+                }
+            }
+            test.equals(window.size(), small_size);
+            test.check(std::equal(window.begin(), window.end(), Iotaterator<data_t>{big_size - small_size}));
+        }),
+
+        make_test<PrettyTest>("stack storage recycles non-LIFO frees", [](auto& test){
+            using data_t = size_t;
+            const size_t nbytes = (small_size + 2) * (sizeof(data_t) + 2 * sizeof(void*));
+            using alloc = StackAllocator<data_t, nbytes>;
+            auto storage = StackStorage<nbytes>();
+            auto window = List<data_t, alloc>(alloc(storage));
+            // pop_front frees are never the last allocation, so before the
+            // free lists this loop exhausted the arena almost immediately
+            for (size_t i = 0; i < big_size; ++i) {
+                window.push_back(i);
+                if (window.size() > small_size) {
+                    window.pop_front();
+                }
+            }
+            test.equals(window.size(), small_size);
+            test.check(std::equal(window.begin(), window.end(), Iotaterator<data_t>{big_size - small_size}));
+        }),
+
+        make_test<PrettyTest>("mark and rewind", [](auto& test){
+            using data_t = size_t;
+            const size_t nbytes = (small_size + 2) * (sizeof(data_t) + 2 * sizeof(void*));
+            using alloc = StackAllocator<data_t, nbytes>;
+            auto storage = StackStorage<nbytes>();
+            // several "requests" in a row, each fits only because the
+            // previous one was rewound wholesale
+            for (int request = 0; request < 3; ++request) {
+                auto guard = typename StackStorage<nbytes>::ScopedRewind(storage);
+                auto list = List<data_t, alloc>(alloc(storage));
+                for (size_t i = 0; i < small_size; ++i) {
+                    list.push_back(i);
+                }
+                test.check(std::equal(list.begin(), list.end(), Iotaterator<data_t>{0}));
+            }
+            test.equals(storage.size, size_t(0));
+            auto marker = storage.mark();
+            auto list = List<data_t, alloc>(alloc(storage));
+            list.push_back(0);
+            test.check(storage.size > marker);
+        }),
+
+        make_test<PrettyTest>("allocation stats", [](auto& test){
+            // a user-provided destructor keeps destroy() on the per-node
+            // path, so every counter ticks once per element
+            struct data_t {
+                size_t value;
+                data_t(size_t v) : value(v) {}
+                ~data_t() { value = 0; }
+            };
+            const size_t nbytes = medium_size * (sizeof(data_t) + 2 * sizeof(void*));
+            using alloc = StackAllocator<data_t, nbytes>;
+            auto storage = StackStorage<nbytes>();
+            {
+                auto list = List<data_t, alloc>(alloc(storage));
+                for (size_t i = 0; i < small_size; ++i) {
+                    list.push_back(i);
+                }
+                test.equals(storage.stats().allocations, small_size);
+                test.equals(storage.stats().high_watermark, storage.size);
+            }
+            test.equals(storage.stats().deallocations, small_size);
+            // every free was either LIFO-reclaimed or recycled
+            test.equals(storage.stats().leaked_deallocations, size_t(0));
+        }),
+
+        make_test<PrettyTest>("trivial teardown skips per-node frees", [](auto& test){
+            using data_t = size_t;
+            const size_t nbytes = medium_size * (sizeof(data_t) + 2 * sizeof(void*));
+            using alloc = StackAllocator<data_t, nbytes>;
+            auto storage = StackStorage<nbytes>();
+            {
+                auto list = List<data_t, alloc>(alloc(storage));
+                for (size_t i = 0; i < small_size; ++i) {
+                    list.push_back(i);
+                }
+                list.clear();
+                test.equals(list.size(), size_t(0));
+                list.push_back(0);
+            }
+            // trivially destructible elements in an arena: nothing walks the
+            // dying list, the storage reclaims everything at rewind instead
+            test.equals(storage.stats().deallocations, size_t(0));
+            test.check(storage.size > 0);
+            storage.rewind(0);
+            test.equals(storage.size, size_t(0));
+        }),
+
+        make_test<PrettyTest>("heap storage", [](auto& test){
+            using data_t = size_t;
+            const size_t nbytes = 1 << 20;
+            using alloc = StackAllocator<data_t, nbytes, HeapStorage<nbytes>>;
+            auto storage = std::make_unique<HeapStorage<nbytes>>();
+            auto list = List<data_t, alloc>(alloc(*storage));
+            for (size_t i = 0; i < big_size; ++i) {
+                list.push_back(i);
+            }
+            test.equals(list.size(), big_size);
+            test.check(std::equal(list.begin(), list.end(), Iotaterator<data_t>{0}));
+            list.sort(std::greater<data_t>());
+            test.check(std::equal(list.rbegin(), list.rend(), Iotaterator<data_t>{0}));
+        }),
+
+        make_test<PrettyTest>("thread-local storage", [](auto& test){
+            using data_t = size_t;
+            const size_t nbytes = 1 << 16;
+            using alloc = ThreadLocalAllocator<data_t, nbytes>;
+            const size_t num_threads = 4;
+            std::vector<data_t> sums(num_threads, 0);
+            std::vector<std::thread> workers;
+            for (size_t worker = 0; worker < num_threads; ++worker) {
+                workers.emplace_back([worker, &sums] {
+                    List<data_t, alloc> list;
+                    for (size_t i = 0; i < medium_size; ++i) {
+                        list.push_back(i + worker);
+                    }
+                    for (data_t item : list) {
+                        sums[worker] += item;
+                    }
+                });
+            }
+            for (auto& thread : workers) {
+                thread.join();
+            }
+            const data_t base = medium_size * (medium_size - 1) / 2;
+            for (size_t worker = 0; worker < num_threads; ++worker) {
+                test.equals(sums[worker], base + worker * medium_size);
+            }
+            // slabs returned by finished threads are handed out again
+            List<data_t, alloc> local;
+            local.push_back(1);
+            test.equals(local.size(), size_t(1));
+        }),
+
+        make_test<PrettyTest>("pmr resource", [](auto& test){
+            using data_t = size_t;
+            const size_t nbytes = medium_size * (sizeof(data_t) + 4 * sizeof(void*));
+            auto storage = StackStorage<nbytes>();
+            auto resource = StackStorageResource(storage);
+            using pmr_list = List<data_t, std::pmr::polymorphic_allocator<data_t>>;
+            auto list = pmr_list(std::pmr::polymorphic_allocator<data_t>(&resource));
+            for (size_t i = 0; i < medium_size; ++i) {
+                list.push_back(i);
+            }
+            test.equals(list.size(), medium_size);
+            test.check(std::equal(list.begin(), list.end(), Iotaterator<data_t>{0}));
+            test.check(storage.size > 0);
+            auto other_resource = StackStorageResource(storage);
+            test.check(resource.is_equal(other_resource));
+        }),
+
         make_test<PrettyTest>("Memory limits", [](auto& test){
             if constexpr (std::is_base_of_v<std::false_type, StackAllocator<int, 1>>) {
                 std::cout << "Skipping this test, as proper StackAllocator isn't present\n";
@@ -408,12 +1208,113 @@ TestGroup create_allocator_tests() {
     };
 }
 
+TestGroup create_serialization_tests() {
+    return { "serialization",
+        make_test<PrettyTest>("binary round trip", [](auto& test) {
+#if __has_include(<unistd.h>) && __has_include(<sys/mman.h>)
+            List<size_t> list;
+            for (size_t i = 0; i < medium_size; ++i) {
+                list.push_back(i);
+            }
+            char path[] = "/tmp/list_serialize_XXXXXX";
+            int fd = mkstemp(path);
+            test.check(fd >= 0);
+            list.serialize(fd);
+            close(fd);
+            auto loaded = List<size_t>::load_mapped(path);
+            test.equals(loaded.size(), medium_size);
+            test.check(std::equal(loaded.begin(), loaded.end(), Iotaterator<size_t>{0}));
+            unlink(path);
+
+            // an empty list round-trips as just the header
+            char empty_path[] = "/tmp/list_serialize_XXXXXX";
+            fd = mkstemp(empty_path);
+            test.check(fd >= 0);
+            List<size_t>().serialize(fd);
+            close(fd);
+            test.equals(List<size_t>::load_mapped(empty_path).size(), size_t(0));
+            unlink(empty_path);
+
+            try {
+                List<size_t>::load_mapped("/nonexistent/list.bin");
+                test.fail();
+            } catch (std::runtime_error&) { }
+#else
+            std::cout << "Skipping: no POSIX I/O on this platform\n";
+            test.check(true);
+#endif
+        })
+    };
+}
+
+TestGroup create_mpsc_tests() {
+    return { "mpsc queue",
+        make_test<PrettyTest>("fifo order and drain", [](auto& test) {
+            MpscQueue<size_t> queue;
+            for (size_t i = 0; i < small_size; ++i) {
+                queue.push(i);
+            }
+            size_t value = small_size;
+            test.check(queue.try_pop(value));
+            test.equals(value, size_t(0));
+            List<size_t> batch;
+            test.equals(queue.drain_to(batch), small_size - 1);
+            test.check(std::equal(batch.begin(), batch.end(), Iotaterator<size_t>{1}));
+            test.check(!queue.try_pop(value));
+            // drained nodes belong to the list now and can be reshaped freely
+            batch.reverse();
+            test.check(std::equal(batch.rbegin(), batch.rend(), Iotaterator<size_t>{1}));
+        }),
+        make_test<PrettyTest>("concurrent producers", [](auto& test) {
+            MpscQueue<size_t> queue;
+            const size_t num_producers = 4;
+            std::vector<std::thread> producers;
+            for (size_t producer = 0; producer < num_producers; ++producer) {
+                producers.emplace_back([producer, &queue] {
+                    for (size_t i = 0; i < medium_size; ++i) {
+                        queue.push(producer * medium_size + i);
+                    }
+                });
+            }
+            List<size_t> seen;
+            while (seen.size() < num_producers * medium_size) {
+                queue.drain_to(seen);
+            }
+            for (auto& producer : producers) {
+                producer.join();
+            }
+            test.equals(seen.size(), num_producers * medium_size);
+            // every pushed value arrives exactly once, and values from one
+            // producer keep their order through the interleaving
+            std::vector<size_t> next_expected(num_producers, 0);
+            bool ordered = true;
+            for (size_t item : seen) {
+                size_t producer = item / medium_size;
+                ordered &= (item % medium_size == next_expected[producer]);
+                ++next_expected[producer];
+            }
+            test.check(ordered);
+            for (size_t producer = 0; producer < num_producers; ++producer) {
+                test.equals(next_expected[producer], medium_size);
+            }
+        })
+    };
+}
+
 
 int main() {
     groups_t groups {};
     groups.push_back(create_constructor_tests());
+    groups.push_back(create_move_tests());
     groups.push_back(create_modification_tests());
+    groups.push_back(create_node_surgery_tests());
+    groups.push_back(create_capacity_tests());
+    groups.push_back(create_small_buffer_tests());
+    groups.push_back(create_unrolled_tests());
+    groups.push_back(create_compact_tests());
     groups.push_back(create_allocator_tests());
+    groups.push_back(create_mpsc_tests());
+    groups.push_back(create_serialization_tests());
 
     bool res = true;
     for (auto& group : groups) {